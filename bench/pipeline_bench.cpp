@@ -0,0 +1,429 @@
+#include "fixparser.hpp"
+#include "fixparser_book.hpp"
+#include "fixparser_projection.hpp"
+#include "fixparser_encoder.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+// Benchmark of every stage of the validation pipeline, and of the encoder, over a corpus of FIX44 messages.
+// Usage: pipeline_bench [--spec <dir>] [--json <file>] [--label <name>] [--compare <file>] [--threshold <percent>] [--min-time <ms>]
+// The results written with --json can be given to --compare by a later run, which then fails on regressions
+
+namespace {
+
+// Every allocation of the process is counted, the measured loops are single threaded
+std::uint64_t allocations{};
+
+}// namespace
+
+auto operator new(std::size_t size) -> void* {
+
+    ++allocations;
+
+    if( auto memory = std::malloc( size == 0 ? 1 : size ) ){
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+// Kept out of line: once inlined in a container, GCC pairs the free() with the operator new call and warns of a mismatch
+[[gnu::noinline]] auto operator delete(void* memory) noexcept -> void {
+    std::free( memory );
+}
+
+[[gnu::noinline]] auto operator delete(void* memory, std::size_t) noexcept -> void {
+    std::free( memory );
+}
+
+namespace {
+
+constexpr char soh = '|';
+constexpr std::int64_t sendingTime = 1524678700123000000; // 20180425-17:51:40.123
+
+auto header(fixparser::Encoder& encoder, std::string_view msgType, std::int64_t seqNum) -> fixparser::Encoder& {
+    return encoder.start( "FIX.4.4", msgType )
+                  .addInt( 34, seqNum )
+                  .add( 49, "TRADEBOTMD002" )
+                  .addTimestamp( 52, sendingTime + seqNum * 1000000 )
+                  .add( 56, "BITWYRE" );
+}
+
+auto logon(fixparser::Encoder& encoder, std::int64_t seqNum) -> std::string_view {
+    return header( encoder, "A", seqNum ).addInt( 98, 0 ).addInt( 108, 30 ).addChar( 141, 'Y' ).finish();
+}
+
+auto newOrderSingle(fixparser::Encoder& encoder, std::int64_t seqNum) -> std::string_view {
+    return header( encoder, "D", seqNum )
+              .add( 1, "ACCOUNT01" ).addInt( 11, 1000000 + seqNum ).addChar( 21, '1' ).add( 55, "BTCUSD" )
+              .addChar( 54, '1' ).addTimestamp( 60, sendingTime ).addDecimal( 38, { 150, 0 } ).addChar( 40, '2' )
+              .addDecimal( 44, { 650025, 2 } ).addChar( 59, '0' ).finish();
+}
+
+auto executionReport(fixparser::Encoder& encoder, std::int64_t seqNum) -> std::string_view {
+    return header( encoder, "8", seqNum )
+              .add( 37, "OID77812" ).addInt( 11, 1000000 + seqNum ).add( 17, "EXEC556201" ).addChar( 150, 'F' )
+              .addChar( 39, '1' ).add( 55, "BTCUSD" ).addChar( 54, '1' ).addDecimal( 38, { 150, 0 } )
+              .addDecimal( 44, { 650025, 2 } ).addDecimal( 32, { 50, 0 } ).addDecimal( 31, { 650010, 2 } )
+              .addDecimal( 151, { 100, 0 } ).addDecimal( 14, { 50, 0 } ).addDecimal( 6, { 650010, 2 } )
+              .addTimestamp( 60, sendingTime ).finish();
+}
+
+// The message of the README
+auto marketDataRequest(fixparser::Encoder& encoder, std::int64_t seqNum) -> std::string_view {
+    return header( encoder, "V", seqNum )
+              .addInt( 262, 2 ).addChar( 263, '1' ).addInt( 264, 1 ).addChar( 265, '0' )
+              .addInt( 146, 1 ).add( 55, "BTCUSD" )
+              .addInt( 267, 1 ).addChar( 269, '0' ).finish();
+}
+
+auto snapshot(fixparser::Encoder& encoder, std::int64_t seqNum, int entries) -> std::string_view {
+
+    auto& body = header( encoder, "W", seqNum ).addInt( 262, 2 ).add( 55, "BTCUSD" ).addInt( 268, entries );
+
+    for(int i{0}; i != entries; ++i ){
+        body.addChar( 269, i % 2 == 0 ? '0' : '1' )
+            .addDecimal( 270, { 650000 + ( i % 2 == 0 ? -i : i ) * 25, 2 } )
+            .addDecimal( 271, { 10 + i % 7 * 5, 1 } )
+            .addInt( 346, i / 2 + 1 );
+    }
+
+    return body.finish();
+}
+
+struct Result{
+    std::string message_;
+    std::string stage_;
+    std::size_t bytes_{};
+    double nsPerMsg_{};
+    double allocsPerMsg_{};
+};
+
+/**
+ * @brief Run f over and over for at least minTime, after a warm up
+ **/
+auto measure(const std::string& message, const char* stage, std::size_t bytes, std::chrono::milliseconds minTime,
+             const std::function<std::size_t()>& f) -> Result {
+
+    // Keeps the compiler from dropping the measured work
+    static volatile std::size_t sink{};
+
+    for(int i{0}; i != 1000; ++i ){
+        sink = sink + f();
+    }
+
+    std::uint64_t iterations{};
+    auto allocationsBefore = allocations;
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::duration{};
+
+    while( elapsed < minTime ){
+
+        for(int i{0}; i != 1000; ++i ){
+            sink = sink + f();
+        }
+
+        iterations += 1000;
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+
+    auto nanoseconds = std::chrono::duration<double, std::nano>( elapsed ).count();
+
+    return { message, stage, bytes, nanoseconds / iterations, static_cast<double>( allocations - allocationsBefore ) / iterations };
+}
+
+auto print(const Result& result) -> void {
+
+    std::cout << std::left << std::setw(20) << result.message_ << std::setw(24) << result.stage_
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << result.nsPerMsg_ << " ns/msg"
+              << std::setw(12) << std::setprecision(2) << 1000.0 / result.nsPerMsg_ << " Mmsg/s"
+              << std::setw(10) << std::setprecision(1) << result.bytes_ / result.nsPerMsg_ * 1000.0 << " MB/s"
+              << std::setw(8) << std::setprecision(2) << result.allocsPerMsg_ << " allocs/msg\n";
+}
+
+// One result per line, so that --compare can read it back without a JSON parser
+auto writeJson(const std::string& path, const std::string& label, const std::vector<Result>& results) -> bool {
+
+    std::ofstream out( path );
+
+    out << "{\n  \"label\": \"" << label << "\",\n  \"results\": [\n";
+
+    for(std::size_t i{0}; i != results.size(); ++i ){
+
+        const auto& result = results[i];
+
+        out << std::fixed << std::setprecision(3)
+            << "    {\"message\": \"" << result.message_ << "\", \"stage\": \"" << result.stage_
+            << "\", \"bytes\": " << result.bytes_
+            << ", \"ns_per_msg\": " << result.nsPerMsg_
+            << ", \"msgs_per_s\": " << 1e9 / result.nsPerMsg_
+            << ", \"bytes_per_s\": " << result.bytes_ * 1e9 / result.nsPerMsg_
+            << ", \"allocs_per_msg\": " << result.allocsPerMsg_ << "}"
+            << ( i + 1 == results.size() ? "\n" : ",\n" );
+    }
+
+    out << "  ]\n}\n";
+
+    return static_cast<bool>( out );
+}
+
+// The string value of key in a line written by writeJson()
+auto jsonValue(const std::string& line, const std::string& key) -> std::string {
+
+    auto begin = line.find( "\"" + key + "\": " );
+
+    if( begin == std::string::npos ){
+        return {};
+    }
+
+    begin += key.size() + 4;
+
+    if( line[begin] == '"' ){
+        return line.substr( begin + 1, line.find( '"', begin + 1 ) - begin - 1 );
+    }
+
+    return line.substr( begin, line.find_first_of( ",}", begin ) - begin );
+}
+
+/**
+ * @brief Compare the results with those of a previous run
+ * @return the number of results slower than the baseline by more than threshold percent
+ **/
+auto compare(const std::string& path, const std::vector<Result>& results, double threshold) -> int {
+
+    std::ifstream in( path );
+    std::string line;
+    int regressions{};
+
+    std::cout << "\nCompared to " << path << "\n";
+
+    while( std::getline( in, line ) ){
+
+        auto message = jsonValue( line, "message" );
+        auto stage = jsonValue( line, "stage" );
+
+        if( message.empty() ){
+            continue;
+        }
+
+        auto found = std::find_if( results.begin(), results.end(), [&](const auto& result){
+                                       return result.message_ == message && result.stage_ == stage;
+                                   });
+
+        if( found == results.end() ){
+            continue;
+        }
+
+        auto baseline = std::stod( jsonValue( line, "ns_per_msg" ) );
+        auto change = ( found->nsPerMsg_ - baseline ) / baseline * 100.0;
+        auto isRegression = change > threshold;
+
+        regressions += isRegression;
+
+        std::cout << std::left << std::setw(20) << message << std::setw(24) << stage
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << baseline << " -> " << std::setw(10) << found->nsPerMsg_ << " ns/msg "
+                  << std::showpos << std::setw(8) << change << std::noshowpos << "%"
+                  << ( isRegression ? "  REGRESSION" : "" ) << "\n";
+    }
+
+    return regressions;
+}
+
+}// namespace
+
+auto main(int argc, char** argv) -> int {
+
+    std::string specDir = "/usr/local/etc";
+    std::string jsonPath;
+    std::string label = "current";
+    std::string baselinePath;
+    double threshold = 10.0;
+    std::chrono::milliseconds minTime{200};
+
+    for(int i{1}; i < argc; ++i ){
+
+        std::string arg = argv[i];
+
+        if( arg == "--spec" && i + 1 < argc ){
+            specDir = argv[++i];
+        }else if( arg == "--json" && i + 1 < argc ){
+            jsonPath = argv[++i];
+        }else if( arg == "--label" && i + 1 < argc ){
+            label = argv[++i];
+        }else if( arg == "--compare" && i + 1 < argc ){
+            baselinePath = argv[++i];
+        }else if( arg == "--threshold" && i + 1 < argc ){
+            threshold = std::stod( argv[++i] );
+        }else if( arg == "--min-time" && i + 1 < argc ){
+            minTime = std::chrono::milliseconds( std::stol( argv[++i] ) );
+        }else{
+            std::cerr << "Unknown option " << arg << "\n";
+            return 2;
+        }
+    }
+
+    fixparser::Config cfg( specDir, soh );
+    auto dictionary = cfg.getDictionary();
+
+    if( !dictionary ){
+        std::cerr << "Cannot open the FIX spec file from " << specDir << "\n";
+        return 1;
+    }
+
+    using Generator = std::function<std::string_view(fixparser::Encoder&, std::int64_t)>;
+
+    std::vector<std::pair<std::string, Generator>> corpus = {
+        { "Logon", logon },
+        { "NewOrderSingle", newOrderSingle },
+        { "ExecutionReport", executionReport },
+        { "MarketDataRequest", marketDataRequest },
+        { "Snapshot-10", [](auto& encoder, auto seqNum){ return snapshot( encoder, seqNum, 10 ); } },
+        { "Snapshot-200", [](auto& encoder, auto seqNum){ return snapshot( encoder, seqNum, 200 ); } },
+    };
+
+    std::vector<Result> results;
+
+    for(const auto& [name, generate]: corpus ){
+
+        std::vector<char> buffer;
+        fixparser::Encoder encoder( buffer, soh );
+
+        std::string msg( generate( encoder, 2 ) );
+        auto bytes = msg.size();
+
+        fixparser::Parser parser( dictionary, soh );
+
+        if( !parser.checkMsgValidity( msg ) ){
+            std::cerr << name << " isn't valid\n" << parser.getErrors();
+            return 1;
+        }
+
+        fixparser::DelimiterIndex index;
+        fixparser::FieldArray fields;
+        fixparser::FixMessage message;
+        fixparser::ErrorBag errors;
+        fixparser::TagSet seen( dictionary->maxNumber() );
+
+        fixparser::scanDelimiters( msg, soh, index );
+        fixparser::tokenize( msg, soh, index, fields );
+        message.reset( msg, dictionary.get() );
+        static_cast<void>( fixparser::categorize( msg, fields, *dictionary, message, errors ) );
+
+        auto run = [&](const char* stage, const std::function<std::size_t()>& f){
+            results.emplace_back( measure( name, stage, bytes, minTime, f ) );
+            print( results.back() );
+        };
+
+        run( "scan", [&](){
+            fixparser::scanDelimiters( msg, soh, index );
+            return index.byteSum_;
+        });
+
+        run( "tokenize", [&](){
+            return fixparser::tokenize( msg, soh, index, fields );
+        });
+
+        run( "categorize", [&](){
+            message.fields_.clear();
+            return static_cast<std::size_t>( fixparser::categorize( msg, fields, *dictionary, message, errors ) );
+        });
+
+        run( "required", [&](){
+            return static_cast<std::size_t>( fixparser::hasRequiredFields( message, *dictionary, seen, errors ) );
+        });
+
+        run( "groups", [&](){
+            message.groups_.clear();
+            message.slots_.clear();
+            return static_cast<std::size_t>( fixparser::decodeGroups( message, *dictionary, errors ) );
+        });
+
+        run( "bodyLength", [&](){
+            return static_cast<std::size_t>( fixparser::checkBodyLength( message, errors ) );
+        });
+
+        run( "checkSum", [&](){
+            return static_cast<std::size_t>( fixparser::checkCheckSum( message, soh, index.byteSum_, errors ) );
+        });
+
+        run( "checkMsgValidity", [&](){
+            return static_cast<std::size_t>( parser.checkMsgValidity( msg ) );
+        });
+
+        fixparser::Parser hotParser( dictionary, soh );
+        hotParser.specialize( message.getValue( 35 ) );
+
+        run( "checkMsgValidity/hot", [&](){
+            return static_cast<std::size_t>( hotParser.checkMsgValidity( msg ) );
+        });
+
+        // The tags a drop copy reads from an ExecutionReport
+        auto projection = fixparser::Projection::of<35, 11, 37, 39, 14, 6>( soh );
+
+        run( "project", [&](){
+            return static_cast<std::size_t>( projection.apply( msg ) );
+        });
+
+        run( "project/EARLY_STOP", [&](){
+            return static_cast<std::size_t>( projection.apply( msg, fixparser::ProjectionMode::EARLY_STOP ) );
+        });
+
+        cfg.setValidation( fixparser::ValidationLevel::FULL );
+        fixparser::Parser fullParser( cfg );
+        cfg.setValidation( fixparser::ValidationLevel::STRUCTURE );
+
+        run( "checkMsgValidity/FULL", [&](){
+            return static_cast<std::size_t>( fullParser.checkMsgValidity( msg ) );
+        });
+
+        if( name.rfind( "Snapshot", 0 ) == 0 ){
+
+            fixparser::BookBuilder books;
+
+            run( "book", [&](){
+                return static_cast<std::size_t>( books.apply( parser.getMessage() ).applied_ );
+            });
+        }
+
+        std::string text;
+        text.reserve( 64 * 1024 );
+
+        run( "toHuman/ONE_LINE", [&](){
+            text.clear();
+            parser.toHuman( text, fixparser::HumanFormat::ONE_LINE );
+            return text.size();
+        });
+
+        run( "toHuman/JSON", [&](){
+            text.clear();
+            parser.toHuman( text, fixparser::HumanFormat::JSON );
+            return text.size();
+        });
+
+        std::int64_t seqNum{2};
+
+        run( "encode", [&](){
+            return generate( encoder, ++seqNum ).size();
+        });
+
+        std::cout << "\n";
+    }
+
+    if( !jsonPath.empty() && !writeJson( jsonPath, label, results ) ){
+        std::cerr << "Cannot write " << jsonPath << "\n";
+        return 1;
+    }
+
+    if( !baselinePath.empty() && compare( baselinePath, results, threshold ) != 0 ){
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "fixparser.hpp"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+// Microbenchmark of the delimiter scan: the split()/getline path against the scalar and vectorized scanners
+
+namespace {
+
+// A MarketDataSnapshotFullRefresh with the given number of entries, BodyLength and CheckSum computed
+auto makeSnapshot(int entries, const char soh) -> std::string {
+
+    std::string body;
+    body += "35=W"; body += soh;
+    body += "34=12"; body += soh;
+    body += "49=BITWYRE"; body += soh;
+    body += "52=20180425-17:51:40.000"; body += soh;
+    body += "56=TRADEBOTMD002"; body += soh;
+    body += "262=2"; body += soh;
+    body += "55=BTCUSD"; body += soh;
+    body += "268="; body += std::to_string(entries); body += soh;
+
+    for(int i{0}; i != entries; ++i){
+        body += "269="; body += std::to_string(i % 2); body += soh;
+        body += "270="; body += std::to_string(6500 + i); body += ".25"; body += soh;
+        body += "271="; body += std::to_string(1 + i % 7); body += ".5"; body += soh;
+        body += "1023="; body += std::to_string(i / 2 + 1); body += soh;
+    }
+
+    std::string msg = "8=FIX.4.4";
+    msg += soh; msg += "9="; msg += std::to_string(body.size()); msg += soh;
+    msg += body;
+
+    unsigned sum{};
+    for(auto c: msg ){
+        sum += c == soh ? 1u : static_cast<unsigned char>(c);
+    }
+
+    auto checkSum = std::to_string(sum % 256);
+    msg += "10="; msg += std::string(3 - checkSum.size(), '0'); msg += checkSum; msg += soh;
+
+    return msg;
+}
+
+template<typename F>
+auto measure(const char* name, const std::string& msg, int iterations, F&& f) -> void {
+
+    // Keeps the compiler from dropping the measured work
+    static volatile std::size_t sink{};
+
+    // Warm up
+    for(int i{0}; i != iterations / 10; ++i){
+        sink = sink + f(msg);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    for(int i{0}; i != iterations; ++i){
+        sink = sink + f(msg);
+    }
+
+    auto elapsed = std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count();
+    auto nsPerMsg = elapsed / iterations;
+
+    std::cout << std::left << std::setw(28) << name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(1) << nsPerMsg << " ns/msg"
+              << std::setw(12) << std::setprecision(1) << ( msg.size() / nsPerMsg ) * 1000.0 << " MB/s\n";
+}
+
+} // namespace
+
+auto main() -> int {
+
+    const char soh = '|';
+    const int iterations = 200000;
+
+    for(int entries: {2, 10, 40} ){
+
+        auto msg = makeSnapshot( entries, soh );
+
+        std::cout << "\nMarketDataSnapshotFullRefresh, " << entries << " entries, " << msg.size() << " bytes\n";
+
+        // What checkMsgValidity used to do: split on SOH then on '=' and sum the bytes for the checksum
+        measure("split() + checksum loop", msg, iterations, [soh](const std::string& m){
+
+            std::size_t count{};
+            for(auto& tagValue: fixparser::split( m, soh ) ){
+                count += fixparser::split( tagValue, '=' ).size();
+            }
+
+            std::uint16_t sum{};
+            for(std::size_t i{0}; i != m.size() - 7; ++i ){
+                sum += m.at(i) == soh ? 1 : m.at(i);
+            }
+
+            return count + sum % 256;
+        });
+
+        fixparser::FieldArray fields;
+        fixparser::DelimiterIndex index;
+
+        measure("tokenize() single pass", msg, iterations, [&fields, soh](const std::string& m){
+            return fixparser::tokenize( m, soh, fields );
+        });
+
+        auto scanMode = [&](const char* name, fixparser::simd::ScanMode mode){
+            measure(name, msg, iterations, [&, mode](const std::string& m){
+                fixparser::simd::scan( m, soh, index, mode );
+                return fixparser::tokenize( m, soh, index, fields ) + index.byteSum_ % 256;
+            });
+        };
+
+        scanMode("scan + tokenize (scalar)", fixparser::simd::ScanMode::SCALAR);
+
+#ifdef FIXPARSER_X86_SIMD
+        scanMode("scan + tokenize (SSE2)", fixparser::simd::ScanMode::SSE2);
+
+        if( fixparser::simd::bestScanMode() == fixparser::simd::ScanMode::AVX2 ){
+            scanMode("scan + tokenize (AVX2)", fixparser::simd::ScanMode::AVX2);
+        }
+#endif
+    }
+
+    return 0;
+}
@@ -0,0 +1,284 @@
+#include "fixparser.hpp"
+#include <fstream>
+#include <iostream>
+
+// Generate a header of constexpr tables from a FIX specification, e.g fixgen FIX44.xml fixparser_fix44.hpp
+// The tables are declared in namespace fixparser::<name>, the name being the lowercase file name of the spec.
+// Extensions given with --extension are merged on top of the spec, in order
+
+namespace {
+
+// Quote a value of the spec as a C++ string literal
+auto quote(std::string_view value) -> std::string {
+
+  std::string quoted = "\"";
+
+  for(auto c: value ){
+
+    if( c == '"' || c == '\\' ){
+      quoted += '\\';
+      quoted += c;
+    }else if( c == '\n' ){
+      quoted += "\\n";
+    }else{
+      quoted += c;
+    }
+  }
+
+  quoted += '"';
+
+  return quoted;
+}
+
+auto placement(fixparser::Placement placement) -> const char* {
+
+  switch( placement ){
+    case fixparser::Placement::HEADER:
+      return "Placement::HEADER";
+    case fixparser::Placement::TRAILER:
+      return "Placement::TRAILER";
+    default:
+      return "Placement::BODY";
+  }
+}
+
+auto kind(fixparser::FieldKind kind) -> const char* {
+
+  switch( kind ){
+    case fixparser::FieldKind::INT:
+      return "FieldKind::INT";
+    case fixparser::FieldKind::DECIMAL:
+      return "FieldKind::DECIMAL";
+    case fixparser::FieldKind::TIMESTAMP:
+      return "FieldKind::TIMESTAMP";
+    case fixparser::FieldKind::CHAR:
+      return "FieldKind::CHAR";
+    default:
+      return "FieldKind::STRING";
+  }
+}
+
+auto range(std::size_t begin, std::size_t end) -> std::string {
+  return "{" + std::to_string( begin ) + ", " + std::to_string( end - begin ) + "}";
+}
+
+}// namespace
+
+auto main(int argc, char** argv) -> int {
+
+  if( argc < 3 ){
+    std::cerr << "Usage: " << argv[0] << " <spec file> <output header> [--namespace <name>] [--extension <spec file>]...\n";
+    return 2;
+  }
+
+  fixparser::fs::path specFile = argv[1];
+  std::vector<fixparser::fs::path> specFiles{ specFile };
+  std::string name = specFile.stem().string();
+
+  std::transform( name.begin(), name.end(), name.begin(), [](unsigned char c){ return std::tolower( c ); } );
+
+  for(int i{3}; i < argc; ++i ){
+
+    std::string arg = argv[i];
+
+    if( arg == "--namespace" && i + 1 < argc ){
+      name = argv[++i];
+    }else if( arg == "--extension" && i + 1 < argc ){
+      specFiles.emplace_back( argv[++i] );
+    }else{
+      std::cerr << "Unknown option " << arg << "\n";
+      return 2;
+    }
+  }
+
+  // The dictionary does the flattening of the components and groups, the tables are a dump of it
+  auto dictionary = fixparser::Dictionary::fromFiles( specFiles );
+
+  if( !dictionary ){
+    std::cerr << "Cannot open the FIX spec files\n";
+    return 1;
+  }
+
+  std::ostringstream values;
+  std::ostringstream enums;
+  std::ostringstream fields;
+  std::ostringstream infos;
+  std::ostringstream required;
+  std::ostringstream messages;
+  std::ostringstream groups;
+  std::ostringstream groupMembers;
+
+  std::size_t valueCount{};
+  std::size_t requiredCount{};
+  std::size_t groupCount{};
+  std::size_t memberCount{};
+
+  auto appendField = [&](std::ostringstream& to, fixparser::TagNumber number){
+
+    auto fieldDef = dictionary->field( number );
+
+    if( !fieldDef ){
+      to << "    {},\n";
+      infos << "    {},\n";
+      return;
+    }
+
+    auto firstValue = valueCount;
+
+    for(const auto& value: fieldDef->values_ ){
+      values << "    {" << quote( value.enumValue_ ) << ", " << quote( value.description_ ) << "},\n";
+      enums << "    " << quote( value.enumValue_ ) << ",\n";
+      ++valueCount;
+    }
+
+    to << "    {" << quote( fieldDef->name_ ) << ", " << quote( fieldDef->type_ ) << ", "
+       << placement( fieldDef->placement_ ) << ", " << range( firstValue, valueCount ) << "}, // " << number << "\n";
+
+    // The packed form read by the dictionary while validating, its enum values are those of enums[]
+    auto fieldInfo = dictionary->info( number );
+
+    infos << "    {" << firstValue << ", " << fieldInfo.valueCount_ << ", " << kind( fieldInfo.kind_ ) << ", "
+          << placement( fieldInfo.placement_ ) << ", true, " << ( fieldInfo.isMultipleValue_ ? "true" : "false" )
+          << "}, // " << number << "\n";
+  };
+
+  // The tags from denseTagLimit go to sorted side arrays rather than stretching fields[]
+  fixparser::TagNumber denseMax{};
+
+  for(fixparser::TagNumber number{0}; number <= std::min( dictionary->maxNumber(), fixparser::denseTagLimit - 1 ); ++number ){
+    if( dictionary->field( number ) ){
+      denseMax = number;
+    }
+  }
+
+  for(fixparser::TagNumber number{0}; number <= denseMax; ++number ){
+    appendField( fields, number );
+  }
+
+  std::ostringstream sparseNumbers;
+  std::ostringstream sparseFields;
+
+  for(auto number: dictionary->sparseNumbers() ){
+    sparseNumbers << "    " << number << ",\n";
+    appendField( sparseFields, number );
+  }
+
+  auto sparseCount = dictionary->sparseNumbers().size();
+
+  auto appendRequired = [&](const fixparser::TagSet& fieldSet){
+
+    auto first = requiredCount;
+
+    fieldSet.forEach( [&](fixparser::TagNumber number){
+      required << number << ", ";
+      ++requiredCount;
+    });
+
+    if( requiredCount != first ){
+      required << "\n";
+    }
+
+    return range( first, requiredCount );
+  };
+
+  auto headerRange = appendRequired( dictionary->headerRequired() );
+  auto trailerRange = appendRequired( dictionary->trailerRequired() );
+
+  // Sorted by MsgType so that the output only changes with the spec
+  std::vector<const fixparser::MessageDef*> msgDefs;
+
+  for(const auto& msgDef: dictionary->messages() ){
+    msgDefs.emplace_back( &msgDef );
+  }
+
+  std::sort( msgDefs.begin(), msgDefs.end(), [](auto lhs, auto rhs){ return lhs->msgType_ < rhs->msgType_; } );
+
+  // The groups of a message keep their order since the parent of a group is given by its index
+  auto appendGroups = [&](const std::vector<fixparser::GroupDef>& groupDefs){
+
+    auto first = groupCount;
+
+    for(const auto& groupDef: groupDefs ){
+
+      auto firstMember = memberCount;
+
+      for(auto member: groupDef.members_ ){
+        groupMembers << member << ", ";
+        ++memberCount;
+      }
+
+      groupMembers << "\n";
+
+      groups << "    {" << groupDef.countTag_ << ", " << groupDef.parent_ << ", " << range( firstMember, memberCount ) << "},\n";
+      ++groupCount;
+    }
+
+    return range( first, groupCount );
+  };
+
+  for(auto msgDef: msgDefs ){
+    messages << "    {" << quote( msgDef->msgName_ ) << ", " << quote( msgDef->msgType_ ) << ", " << quote( msgDef->msgCat_ )
+             << ", " << appendRequired( msgDef->requiredFields_ ) << ", " << appendGroups( msgDef->groups_ ) << "},\n";
+  }
+
+  // An array can't be empty, the unused entry is never referenced by a range
+  if( valueCount == 0 ){
+    values << "    {},\n";
+    enums << "    {},\n";
+  }
+
+  if( requiredCount == 0 ){
+    required << "0\n";
+  }
+
+  if( msgDefs.empty() ){
+    messages << "    {},\n";
+  }
+
+  if( groupCount == 0 ){
+    groups << "    {},\n";
+  }
+
+  if( memberCount == 0 ){
+    groupMembers << "0\n";
+  }
+
+  std::ofstream out( argv[2] );
+
+  out << "// Generated by fixgen from " << specFile.filename().string() << ", do not edit\n"
+      << "#pragma once\n\n"
+      << "#include \"fixparser.hpp\"\n\n"
+      << "namespace fixparser::" << name << " {\n\n"
+      << "inline constexpr SpecValue values[] = {\n" << values.str() << "};\n\n"
+      << "inline constexpr std::string_view enums[] = {\n" << enums.str() << "};\n\n"
+      << "inline constexpr SpecField fields[] = {\n" << fields.str() << "};\n\n"
+      << "inline constexpr FieldInfo infos[] = {\n" << infos.str() << "};\n\n"
+      << "inline constexpr TagNumber required[] = {\n" << required.str() << "};\n\n"
+      << "inline constexpr SpecMessage messages[] = {\n" << messages.str() << "};\n\n"
+      << "inline constexpr SpecGroup groups[] = {\n" << groups.str() << "};\n\n"
+      << "inline constexpr TagNumber groupMembers[] = {\n" << groupMembers.str() << "};\n\n";
+
+  if( sparseCount != 0 ){
+    out << "inline constexpr TagNumber sparseNumbers[] = {\n" << sparseNumbers.str() << "};\n\n"
+        << "inline constexpr SpecField sparseFields[] = {\n" << sparseFields.str() << "};\n\n";
+  }
+
+  out << "inline constexpr SpecTables tables{ fields, " << denseMax << ", values, required, messages, "
+      << msgDefs.size() << ", " << headerRange << ", " << trailerRange << ", groups, groupMembers, "
+      << ( sparseCount != 0 ? "sparseNumbers, sparseFields, " : "nullptr, nullptr, " ) << sparseCount << ", infos, enums };\n\n"
+      << "/**\n"
+      << " * @brief Dictionary built from the tables, once per process\n"
+      << " **/\n"
+      << "inline auto dictionary() -> const std::shared_ptr<const Dictionary>& {\n"
+      << "    static const auto dictionary = Dictionary::fromTables( tables );\n"
+      << "    return dictionary;\n"
+      << "}\n\n"
+      << "}// namespace fixparser::" << name << "\n";
+
+  if( !out ){
+    std::cerr << "Cannot write " << argv[2] << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,78 @@
+#include "fixparser_logscan.hpp"
+#include <iostream>
+
+// Validate a FIX log holding one message per line and print a summary of the errors found
+
+auto main(int argc, char** argv) -> int {
+
+  auto usage = [&argv](){
+    std::cerr << "Usage: " << argv[0] << " <log file> [--spec <dir>] [--soh <char>] [--threads <n>] [--offsets] [--extension <spec file>]...\n";
+    return 2;
+  };
+
+  if( argc < 2 ){
+    return usage();
+  }
+
+  std::string specDir = "/usr/local/etc";
+  char soh = '|';
+  fixparser::LogScanOptions options;
+  std::vector<std::string> extensions;
+
+  for(int i{2}; i < argc; ++i ){
+
+    std::string arg = argv[i];
+
+    if( arg == "--spec" && i + 1 < argc ){
+      specDir = argv[++i];
+    }else if( arg == "--soh" && i + 1 < argc ){
+      soh = argv[++i][0];
+    }else if( arg == "--threads" ){
+
+      std::uint32_t workers{};
+
+      if( i + 1 == argc || !fixparser::toUnsigned( argv[++i], workers ) || workers == 0 ){
+        std::cerr << "--threads expects a number of threads above 0\n";
+        return usage();
+      }
+
+      options.workers_ = workers;
+    }else if( arg == "--offsets" ){
+      options.collectOffsets_ = true;
+    }else if( arg == "--extension" && i + 1 < argc ){
+      extensions.emplace_back( argv[++i] );
+    }else{
+      std::cerr << "Unknown option " << arg << "\n";
+      return usage();
+    }
+  }
+
+  fixparser::Config cfg( specDir, soh );
+
+  for(const auto& extension: extensions ){
+    cfg.addExtension( extension );
+  }
+
+  if( !cfg.getDictionary() ){
+    std::cerr << "Cannot open the FIX spec file from " << specDir << "\n";
+    return 1;
+  }
+
+  fixparser::LogScanSummary summary;
+
+  if( !fixparser::scanLogFile( argv[1], cfg, summary, options ) ){
+    std::cerr << "Cannot open " << argv[1] << "\n";
+    return 1;
+  }
+
+  std::cout << summary;
+
+  if( options.collectOffsets_ && !summary.badOffsets_.empty() ){
+    std::cout << "\nOffsets of the invalid messages\n";
+    for(auto offset: summary.badOffsets_ ){
+      std::cout << "  " << offset << "\n";
+    }
+  }
+
+  return summary.invalid_ == 0 ? 0 : 1;
+}
@@ -1,25 +1,51 @@
+#pragma once
+
 #include <string>
 #include <cstring>
 #include <string_view>
 #include <iostream>
 #include <unordered_map>
+#include <map>
+#include <functional>
 #include <vector>
+#include <array>
 #include <utility>
 #include <filesystem>
 #include <sstream>
 #include <algorithm>
 #include <type_traits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <optional>
+// The runtime loader of XML specifications can be left out when only the generated tables are used
+#ifndef FIXPARSER_NO_PUGIXML
 #include <pugixml.hpp>
+#endif
+
+#if ( defined(__x86_64__) || defined(__i386__) ) && defined(__GNUC__) && defined(__SSE2__)
+    #define FIXPARSER_X86_SIMD 1
+    #include <immintrin.h>
+#endif
 
 
 namespace fixparser {
 
 namespace fs = std::filesystem;
+
+// Tag numbers go beyond 16 bits with the user defined fields of some venues
+using TagNumber = std::uint32_t;
+
+// The tables indexed by tag number stop here, the few tags above it go to sorted side tables
+inline constexpr TagNumber denseTagLimit{65536};
+
 // Defining the necessary types to hold a FIX message
 struct Field{
     std::string fieldName_;
     std::string value_;
-    std::uint16_t number_{};
+    TagNumber number_{};
     bool isRequired_{};
     bool isComponent_{};
     bool isInGroup_{};
@@ -46,669 +72,4064 @@ struct Value{
     std::string description_;
 };
 
-using TagEnum = std::string;
-struct Tag{
-    std::uint16_t number_{};
-    std::string name_;
-    std::string type_;
-    std::string value_;
-    std::unordered_map<TagEnum, Value> tagValues_; // Set of values that a specific Tag can take, this maybe empty for some tags
+// A field of a raw message as found by the tokenizer, the value refers to the tokenized buffer
+struct FieldView{
+    TagNumber number_{}; // 0 when the tag isn't a valid tag number
+    std::string_view value_;
+    std::uint32_t offset_{}; // Position of the first character of the tag in the message
 };
 
-struct Header{
-    std::vector<Tag> headerFields_;
-    Group grp_;
-};
+// The containers filled for each message are std::pmr ones, so that their memory can come from a resource of the caller
+using FieldArray = std::pmr::vector<FieldView>;
 
-struct Body{
-    std::vector<Tag> tagValues_;
+// Positions of every SOH and '=' of a message, in order, along with the sum of its bytes
+struct DelimiterIndex{
+    std::pmr::vector<std::uint32_t> positions_;
+    std::uint32_t byteSum_{}; // SOH counted as 1 whatever the configured SOH is, only the value modulo 256 matters
 };
 
-struct Trailer{
-    std::vector<Tag> trailer_;
+// A field of a parsed message, its value is found in the raw message at [offset_, offset_ + length_).
+// The length is as wide as the offset so that a value of any size in a message is referenced
+struct FieldRef{
+    TagNumber number_{};
+    std::uint32_t length_{};
+    std::uint32_t offset_{};
 };
 
-struct FixMessage{
-    Header header_;
-    Body body_;
-    Trailer trailer_;
-    std::string rawMsg_;
-};
+static_assert( sizeof(FieldRef) == 12 );
 
-enum class FixStd : char {
-    FIX44
-};
+/**
+ * @brief Position of the first character of the tag of field in the raw message
+ **/
+constexpr auto tagBegin(const FieldRef& field) noexcept -> std::uint32_t {
 
-struct Error{
-    std::string errMsg_;
-};
-struct ErrorBag{
-    std::vector<Error> errors_;
+    // Tags are written without leading zeros, the tag and the '=' are right before the value
+    std::uint32_t digits{1};
 
-    auto isEmpty() -> bool {
-        return errors_.empty();
+    for(auto number = field.number_; number >= 10; number /= 10 ){
+        ++digits;
     }
-};
 
-struct Config{
+    return field.offset_ - digits - 1;
+}
 
-    Config(): pathSrc_("/usr/local/etc"), fixStd_(FixStd::FIX44), SOH_('|'){}
+/**
+ * @brief Set of tag numbers kept as a bitset, one bit per tag number below denseTagLimit,
+ * the larger numbers in a sorted array. Checking that a set holds every number of another one
+ * is a word by word AND-NOT
+ **/
+class TagSet{
 
-    template<typename Path>
-    Config(Path&& pathSrc,const char soh='|'): pathSrc_(std::forward<Path>(pathSrc)), SOH_(soh) {}
+    public:
 
-    template<typename Path>
-    Config(Path&& pathSrc, FixStd&& fixStd, const char soh='|'): pathSrc_(std::forward<Path>(pathSrc)),
-                                          fixStd_(std::move(fixStd)), SOH_(soh) {}
-    auto getPath() const{
-        return pathSrc_;
-    }
+        TagSet() = default;
 
-    auto getFixStd() const{
-        return fixStd_;
-    }
+        explicit TagSet(TagNumber maxNumber): words_( std::min( maxNumber, denseTagLimit - 1 ) / 64u + 1 ) {}
 
-    auto getSOH() const{
-        return SOH_;
-    }
+        auto insert(TagNumber number) -> void {
 
-    private:
-        std::string pathSrc_;
-        FixStd fixStd_;
-        char SOH_;
+            if( number >= denseTagLimit ){
 
-};
+                auto found = std::lower_bound( sparse_.begin(), sparse_.end(), number );
 
-auto operator<<(std::ostream& os, ErrorBag errBag) -> std::ostream&{
-    if( errBag.isEmpty() ){
-        os << "No errors found" << "\n";
-        return os;
-    }
+                if( found == sparse_.end() || *found != number ){
+                    sparse_.insert( found, number );
+                }
 
-     os << "A total of " << errBag.errors_.size() << " error(s) found \n\n";
-    for(const auto& err: errBag.errors_ ){
-        os << err.errMsg_ << "\n";
-    }
+                return;
+            }
 
-    return os;
-}
+            auto word = number / 64u;
 
-ErrorBag errorBag{};
-pugi::xml_document fixSpec;
-FixMessage fixMessage;
+            if( word >= words_.size() ){
+                words_.resize( word + 1 );
+            }
 
-/**
- * @brief Retrieve the list of errors that occured during parsing
- * @return ErrorBag
- **/
-auto getErrors() -> ErrorBag {
-     return errorBag;
-}
+            words_[word] |= bit( number );
+        }
 
-template <typename T,typename S=std::enable_if_t< std::is_convertible_v<T, std::string>, std::string> >
-[[nodiscard]] constexpr auto split(T&& str, const char delimiter) noexcept -> std::vector<S> {
+        auto contains(TagNumber number) const noexcept -> bool {
 
-  auto strToConvert = std::string(std::forward<T>(str));
-  std::vector<S> internal;
+            if( number >= denseTagLimit ){
+                return std::binary_search( sparse_.begin(), sparse_.end(), number );
+            }
 
-  std::stringstream ss( std::forward<S>(strToConvert)); // Turn the string into a stream.
-  std::string tok;
+            auto word = number / 64u;
+            return word < words_.size() && ( words_[word] & bit( number ) ) != 0;
+        }
 
-  while (getline(ss, tok, delimiter)) {
-    internal.emplace_back(tok);
-  }
+        /**
+         * @brief Remove every number, keeping the memory of the set
+         **/
+        auto clear() noexcept -> void {
+            std::fill( words_.begin(), words_.end(), 0 );
+            sparse_.clear();
+        }
 
-  return internal;
-}
+        auto operator|=(const TagSet& other) -> TagSet& {
 
-template<typename T>
-constexpr auto printFieldImpl(T&& tag, std::false_type) -> void {
+            if( other.words_.size() > words_.size() ){
+                words_.resize( other.words_.size() );
+            }
 
-    std::cout <<  tag.number_ << "\t\t";
+            for(std::size_t i{0}; i != other.words_.size(); ++i ){
+                words_[i] |= other.words_[i];
+            }
 
-    if( !tag.tagValues_.empty() ){
-        
-        if(auto foundTag = tag.tagValues_.find( tag.value_ );
-            foundTag != tag.tagValues_.end() ){
+            for(auto number: other.sparse_ ){
+                insert( number );
+            }
 
-            std::cout << tag.name_ << ": " << foundTag->second.description_ << " (" << tag.value_ << ")\n\n";
-        }else{
-            std::cout << tag.value_ << " is not a correct value for tag " << tag.name_ << "\n\n";
+            return *this;
         }
-    }else{
-        std::cout << tag.name_ << ": " << tag.value_ << "\n\n";
-    }
-}
 
-template<typename T>
-constexpr auto printFieldImpl(T&& field, std::true_type) -> void {
+        /**
+         * @return true if every number of required is in this set
+         **/
+        auto containsAll(const TagSet& required) const noexcept -> bool {
 
-    std::cout << field.number_<< "\t\t";
-    std::cout << field.fieldName_<< ": " << field.value_ << "\n\n";
-}
+            for(std::size_t i{0}; i != required.words_.size(); ++i ){
+                if( ( required.words_[i] & ~word( i ) ) != 0 ){
+                    return false;
+                }
+            }
 
-template<typename T>
-constexpr auto printField(T&& field) -> void {
-    printFieldImpl( std::forward<T>(field), std::is_same< std::decay_t<T> , Field>() );
-}
-/**
- * @brief Pretty print a FixMessage
- **/
-template<typename T>
-constexpr auto prettyPrint(T&& fixMsg) -> void {
+            return std::includes( sparse_.begin(), sparse_.end(), required.sparse_.begin(), required.sparse_.end() );
+        }
 
-    static_assert( std::is_same_v<std::remove_cv_t<std::remove_reference_t<T>>, FixMessage>);
+        /**
+         * @brief Call f with every number of the set, in increasing order
+         **/
+        template<typename F>
+        auto forEach(F&& f) const -> void {
 
-    if( !errorBag.errors_.empty() ){
-        std::cerr << "The message contains some errors, please check the FIX specification to get the list of correct fields \n\n";
-        std::cerr << errorBag << "\n\n";
-        return;
-    }
-    // Print the header
-    std::cout << "HEADER"  << "\n\n";
-    for(const auto& field: fixMsg.header_.headerFields_ ){
-        printField( field );
-    }
-    // Print the body
-    std::cout << "BODY"  << "\n\n";
-    for(const auto& field: fixMsg.body_.tagValues_ ){
-        printField( field );
-    }
-    // Print the trailer
-    std::cout << "TRAILER"  << "\n\n";
-    for(const auto& field: fixMsg.trailer_.trailer_ ){
-        printField( field );
-    }
-}
+            for(std::size_t i{0}; i != words_.size(); ++i ){
+                for(auto word = words_[i]; word != 0; word &= word - 1 ){
+                    f( static_cast<TagNumber>( i * 64 + lowestBit( word ) ) );
+                }
+            }
 
+            for(auto number: sparse_ ){
+                f( number );
+            }
+        }
 
-/**
- * @brief map a given FIX version to supported one and open the correspoding dictionnary
- * @return true if can open a file with the specified FixStd
- **/
+        /**
+         * @brief Call onMissing with every number of required that isn't in this set, in increasing order
+         **/
+        template<typename F>
+        auto forEachMissing(const TagSet& required, F&& onMissing) const -> void {
 
-[[nodiscard]] auto mapVersionAndOpenFile(Config& config) noexcept -> bool {
-    
-    auto mappedVersion = [&config = std::as_const(config)](){
-        switch (config.getFixStd()){
-            case FixStd::FIX44:
-                return "FIX44";
-                break;
-            default:
-                return "FIX44";
-                break;
+            for(std::size_t i{0}; i != required.words_.size(); ++i ){
+
+                for(auto missing = required.words_[i] & ~word( i ); missing != 0; missing &= missing - 1 ){
+                    onMissing( static_cast<TagNumber>( i * 64 + lowestBit( missing ) ) );
+                }
+            }
+
+            for(auto number: required.sparse_ ){
+                if( !std::binary_search( sparse_.begin(), sparse_.end(), number ) ){
+                    onMissing( number );
+                }
+            }
         }
-    }();
 
-    // Using the overload of fs::current_path that doesn't throw an exception
-    std::error_code ec;
-    
-    // Changing the current directory to the one set on config.getPath()
-    fs::current_path(config.getPath(), ec);
+    private:
 
-    auto currentDir = fs::current_path(ec); 
+        static constexpr auto bit(TagNumber number) noexcept -> std::uint64_t {
+            return std::uint64_t{1} << ( number % 64u );
+        }
 
-    if( ec ){
-        return false;
-    }
+        static constexpr auto lowestBit(std::uint64_t word) noexcept -> unsigned {
+#if defined(__GNUC__)
+            return static_cast<unsigned>( __builtin_ctzll( word ) );
+#else
+            unsigned position{};
+            for(; ( word & 1 ) == 0; word >>= 1 ){
+                ++position;
+            }
+            return position;
+#endif
+        }
+
+        auto word(std::size_t i) const noexcept -> std::uint64_t {
+            return i < words_.size() ? words_[i] : 0;
+        }
+
+        std::vector<std::uint64_t> words_;
+        std::vector<TagNumber> sparse_; // Numbers from denseTagLimit, sorted
+};
 
-    std::string source = currentDir;
-                source += "/fixparser/";
-                source += mappedVersion;
-                source += ".xml";
+enum class FixStd : char {
+    FIX44,
+    FIX42,
+    FIX43,
+    FIX50SP2
+};
 
-    pugi::xml_parse_result result = fixSpec.load_file(source.c_str());
+/**
+ * @brief The BeginString(8) of the messages of fixStd
+ **/
+constexpr auto beginString(FixStd fixStd) noexcept -> std::string_view {
 
-    return static_cast<bool>(result);
+    switch( fixStd ){
+        case FixStd::FIX42:    return "FIX.4.2";
+        case FixStd::FIX43:    return "FIX.4.3";
+        case FixStd::FIX50SP2: return "FIXT.1.1";
+        default:               return "FIX.4.4";
+    }
 }
 
 /**
- * @brief take a vector of string and categorize each element according to the fix spec
- * @return a pair containing the constructed FIX message and an error bag which is empty if no errors found during the process
+ * @brief The ApplVerID(1128) of the messages of fixStd, empty before FIX 5.0 where the version is the BeginString
  **/
+constexpr auto applVerID(FixStd fixStd) noexcept -> std::string_view {
+    return fixStd == FixStd::FIX50SP2 ? "9" : "";
+}
 
-template<typename T,typename=std::enable_if_t< !std::is_integral_v<T> > >
-[[nodiscard]] constexpr auto categorize(T&& vec, Config& config) noexcept -> std::pair<FixMessage,ErrorBag> {
+// Why a message is rejected. The kinds FIX has a SessionRejectReason(373) for take the value of that reason,
+// the others are numbered from 100 and are reported as Other(99), see rejectReason()
+enum class ErrorKind : std::uint8_t {
+    INVALID_TAG_NUMBER = 0,
+    REQUIRED_TAG_MISSING = 1,
+    UNDEFINED_TAG = 3,
+    VALUE_OUT_OF_RANGE = 5,
+    INCORRECT_DATA_FORMAT = 6,
+    INVALID_MSGTYPE = 11,
+    TAG_OUT_OF_ORDER = 14,
+    INCORRECT_NUMINGROUP_COUNT = 16,
+    OTHER = 99,
+    BODY_LENGTH_MISMATCH = 100,
+    CHECKSUM_SIZE = 101,
+    CHECKSUM_MISMATCH = 102,
+    NO_DICTIONARY = 103,
+    UNSUPPORTED_VERSION = 104
+};
 
-    FixMessage fixMsg;
-    Header fixHeader;
-    Body fixBody;
-    Trailer fixTrailer;
+/**
+ * @brief The SessionRejectReason(373) to send back in the Reject of a message failing with kind
+ **/
+constexpr auto rejectReason(ErrorKind kind) noexcept -> std::uint16_t {
+    auto reason = static_cast<std::uint16_t>( kind );
+    return reason < 100 ? reason : 99;
+}
 
-    auto result = mapVersionAndOpenFile( config );
+// An error found in a message, the text describing it is only built by ErrorBag::describe()
+struct Error{
+    ErrorKind kind_{ErrorKind::OTHER};
+    std::uint32_t tag_{};      // Tag number of the field in error, 0 when there's none
+    std::uint32_t offset_{};   // Position of the first character of the tag of the field in the raw message
+    std::int32_t expected_{};  // Value expected by the check, e.g the computed checksum
+    std::int32_t actual_{};    // Value found in the message
+};
 
-    if( result ){
+class Dictionary;
 
-        for(auto& tagValue : vec){
+/**
+ * @brief The errors found in a message, kept in a fixed size array so that reporting them never allocates.
+ * The errors past the capacity are only counted. The raw message and the dictionary the errors were found with
+ * are referred to, they must outlive the bag for its errors to be described
+ **/
+struct ErrorBag{
+    static constexpr std::size_t capacity = 16;
 
-            auto tagValueVec = split(tagValue, '=');
+    std::array<Error, capacity> errors_{};
+    std::uint32_t size_{};
+    std::uint32_t dropped_{};
+    std::string_view rawMsg_;
+    const Dictionary* dictionary_{};
+    char soh_{'|'};
 
-            auto headers = fixSpec.child("fix").child("header");
-            auto trailers = fixSpec.child("fix").child("trailer");
-            auto fields = fixSpec.child("fix").child("fields");
-            Tag tag ;
-            
-            auto isField = fields.find_node([&tagValueVec](auto& node){
-                return
-                std::strcmp(node.attribute("number").as_string(), tagValueVec.front().c_str() ) == 0;
-            });
+    auto add(ErrorKind kind, std::uint32_t tag = 0, std::uint32_t offset = 0, std::int32_t expected = 0, std::int32_t actual = 0) noexcept -> void {
 
-            if( isField ){
-
-              tag.name_ = static_cast<std::string>(isField.attribute("name").as_string());
-              tag.number_ = isField.attribute("number").as_int();
-              tag.type_ = static_cast<std::string>(isField.attribute("type").as_string());
-              tag.value_ = tagValueVec.back();
-
-              // If the field has some set of values we retrieve them
-              for (auto &value : isField.children()) {
-                Value v;
-                v.description_ = static_cast<std::string>(value.attribute("description").as_string());
-                v.enumValue_ = static_cast<std::string>(value.attribute("enum").as_string());
-                tag.tagValues_.emplace(std::make_pair(v.enumValue_, v));
-              }
-
-              auto nodeFoundInHeader =
-                  headers.find_node([&isField](auto &node) {
-                    return
-                    std::strcmp(node.attribute("name").as_string(), isField.attribute("name").as_string() ) == 0;
-                  });
-
-              if (!nodeFoundInHeader) {
-                    auto nodeFoundInTrailer =
-                        trailers.find_node([&isField](auto &node) {
-                        return std::strcmp(
-                                    node.attribute("name").as_string(),
-                                    isField.attribute("name").as_string()) == 0;
-                        });
-
-                    if (nodeFoundInTrailer) {
-                            fixTrailer.trailer_.emplace_back(tag);
-                    } else {
-                        fixBody.tagValues_.emplace_back(tag);
-                    }
-                }else{
-                    fixHeader.headerFields_.emplace_back(tag);
-                }
+        if( size_ == capacity ){
+            ++dropped_;
+            return;
+        }
 
-            }else{
+        errors_[size_++] = Error{ kind, tag, offset, expected, actual };
+    }
 
-                // The field is not a correct field, means we didn't found an attribute number=x
-                // This results in parsing error
-                std::string err = "Field with tag=";
-                            err+= tagValueVec.front();
-                            err+= " not found";
+    auto isEmpty() const noexcept -> bool {
+        return size_ == 0;
+    }
 
-                errorBag.errors_.emplace_back( Error{std::move(err)} );
-            }
+    auto size() const noexcept -> std::size_t {
+        return size_;
+    }
 
-        }
+    auto begin() const noexcept -> const Error* {
+        return errors_.data();
+    }
 
-        fixMsg.header_ = std::move(fixHeader);
-        fixMsg.body_ = std::move(fixBody);
-        fixMsg.trailer_ = std::move(fixTrailer);
+    auto end() const noexcept -> const Error* {
+        return errors_.data() + size_;
+    }
 
-        return std::make_pair(fixMsg, errorBag);
-    }else{
+    auto operator[](std::size_t i) const noexcept -> const Error& {
+        return errors_[i];
+    }
 
-        errorBag.errors_.emplace_back( Error{"Cannot open the FIX spec file."} );
-        return std::make_pair( FixMessage{}, errorBag );
+    auto clear() noexcept -> void {
+        size_ = 0;
+        dropped_ = 0;
     }
-}
 
-/**
- * @brief Check the message validity over a Fix specification
- *       if none is specified the FIX44 standard is used
- * @return true if the message is correct false otherwise
- * When it returns false, the list of errors encountered can be get via the getErrors() method
- * and be displayed e.g: std::cout << fixparser::getErrors() << "\n"
-*/
-template <typename T,typename=std::enable_if_t<std::is_convertible_v<std::decay_t<T>, std::string> > >
-constexpr auto checkMsgValidity(T&& message, Config& config) noexcept -> bool {
+    /**
+     * @brief Clear the errors and refer to the message about to be checked
+     **/
+    auto reset(std::string_view rawMsg, const Dictionary* dictionary, const char soh) noexcept -> void {
+        clear();
+        rawMsg_ = rawMsg;
+        dictionary_ = dictionary;
+        soh_ = soh;
+    }
 
-    auto splittedMsg = split( message, config.getSOH() );
+    /**
+     * @brief The text describing error, naming the fields from the dictionary and quoting the values of the raw message
+     **/
+    auto describe(const Error& error) const -> std::string;
+};
 
-    auto [fixMsg, error] = categorize( splittedMsg, config);
+// Where a field lives in a FIX message according to the specification
+enum class Placement : char {
+    BODY,
+    HEADER,
+    TRAILER
+};
 
-    fixMsg.rawMsg_ = std::forward<T>(message);
+// How the value of a field is read, as given by its type in the specification
+enum class FieldKind : char {
+    STRING,
+    INT,        // INT, LENGTH, NUMINGROUP, SEQNUM...
+    DECIMAL,    // PRICE, QTY, AMT, FLOAT...
+    TIMESTAMP,  // UTCTIMESTAMP
+    CHAR        // CHAR, BOOLEAN
+};
 
-    if( !error.isEmpty() ){
-        return false;
+constexpr auto toFieldKind(std::string_view type) noexcept -> FieldKind {
+
+    if( type == "INT" || type == "LENGTH" || type == "NUMINGROUP" || type == "SEQNUM" || type == "TAGNUM" || type == "DAYOFMONTH" ){
+        return FieldKind::INT;
     }
-    
-    auto requiredFieldsPresent = hasRequiredFields( fixMsg );
 
-    if( !requiredFieldsPresent ){
-        return false;
+    if( type == "PRICE" || type == "QTY" || type == "AMT" || type == "FLOAT" || type == "PERCENTAGE" || type == "PRICEOFFSET" ){
+        return FieldKind::DECIMAL;
     }
 
-    auto bodyLengthCorrect = checkBodyLength( fixMsg );
+    if( type == "UTCTIMESTAMP" ){
+        return FieldKind::TIMESTAMP;
+    }
 
-    if( !bodyLengthCorrect ){
-        return false;
+    if( type == "CHAR" || type == "BOOLEAN" ){
+        return FieldKind::CHAR;
     }
 
-    auto checkSumCorrect = checkCheckSum( fixMsg, config);
+    return FieldKind::STRING;
+}
 
-    if( !checkSumCorrect ){
-        return false;
+struct FieldDef{
+    std::string name_;
+    std::string type_;
+    FieldKind kind_{FieldKind::STRING};
+    Placement placement_{Placement::BODY};
+    std::vector<Value> values_; // Set of values that the field can take, this maybe empty for some fields
+    bool isDefined_{};
+};
+
+// What the validation reads of a field, packed so that the table of every field stays in cache
+struct FieldInfo{
+    std::uint32_t firstValue_{};   // Index of the enum values of the field in the packed values of the dictionary
+    std::uint16_t valueCount_{};
+    FieldKind kind_{FieldKind::STRING};
+    Placement placement_{Placement::BODY};
+    bool isDefined_{};
+    bool isMultipleValue_{};       // MULTIPLEVALUESTRING, several enum values separated by spaces
+};
+
+// A repeating group as defined in one message, its members are flattened through the components
+struct GroupDef{
+    TagNumber countTag_{};             // The NumInGroup field holding the number of entries
+    std::int32_t parent_{-1};              // Index of the enclosing group in MessageDef::groups_, -1 at the top level
+    std::vector<TagNumber> members_;   // In the order of the spec, the first one is the delimiter starting each entry
+    std::vector<std::int32_t> nested_;     // For each member, index of the group it's the NumInGroup field of, or -1
+    std::vector<std::pair<TagNumber, std::uint16_t>> slots_; // (tag number, index in members_) sorted by tag number
+
+    auto delimiter() const noexcept -> TagNumber {
+        return members_.front();
     }
 
-    fixMessage = std::forward<decltype(fixMsg)>(fixMsg);
+    /**
+     * @brief Position of a member in the entries of the group
+     * @return the index of number in members_ or -1 if it's not a member of the group
+     **/
+    auto slot(TagNumber number) const noexcept -> std::int32_t {
 
-    return true;
-}
+        auto found = std::lower_bound( slots_.begin(), slots_.end(), number,
+                                       [](const auto& slot, TagNumber n){ return slot.first < n; });
+
+        return found != slots_.end() && found->first == number ? found->second : -1;
+    }
+};
+
+struct MessageDef{
+    std::string msgName_;
+    std::string msgType_;
+    std::string msgCat_;
+    TagSet requiredFields_;         // Components and groups are flattened into this set
+    TagSet allRequired_;            // The required fields of the body, the header and the trailer
+    std::vector<GroupDef> groups_;  // Every group of the message, nested ones included, header and trailer ones too
+    TagSet groupCounts_;            // The NumInGroup fields of the groups at the top level of the message
+};
+
+// Slice [begin_, begin_ + count_) of one of the arrays of SpecTables
+struct SpecRange{
+    std::uint32_t begin_{};
+    std::uint32_t count_{};
+};
+
+struct SpecValue{
+    std::string_view enumValue_;
+    std::string_view description_;
+};
+
+struct SpecField{
+    std::string_view name_; // Empty when the specification has no field with this number
+    std::string_view type_;
+    Placement placement_{Placement::BODY};
+    SpecRange values_;      // In SpecTables::values_
+};
+
+struct SpecGroup{
+    TagNumber countTag_{};
+    std::int32_t parent_{-1}; // Index of the enclosing group among the groups of the message, -1 at the top level
+    SpecRange members_;       // In SpecTables::groupMembers_
+};
 
-template<typename CompName, typename Msg>
-constexpr auto processComponent(CompName&&, Msg&&) -> bool; 
+struct SpecMessage{
+    std::string_view msgName_;
+    std::string_view msgType_;
+    std::string_view msgCat_;
+    SpecRange requiredFields_; // In SpecTables::required_, components and groups flattened
+    SpecRange groups_;         // In SpecTables::groups_
+};
 
 /**
- *  @brief process groups
- *  @return true if the message has the necessary required fields of the group, false otherwise
+ * @brief A FIX specification as constexpr arrays, as generated by fixgen from the XML at build time.
+ * The lookups are constexpr too, e.g fix44::tables.number("MsgType") can be computed by the compiler
  **/
-template<typename T, typename M>
-constexpr auto processGroup(T&& groupNode, M&& message) -> bool{
-    
-    bool hasRequired{1};
+struct SpecTables{
+    const SpecField* fields_;     // Indexed by tag number, from 0 to maxNumber_ below denseTagLimit
+    TagNumber maxNumber_;
+    const SpecValue* values_;
+    const TagNumber* required_;
+    const SpecMessage* messages_;
+    std::size_t messageCount_;
+    SpecRange headerRequired_;
+    SpecRange trailerRequired_;
+    const SpecGroup* groups_;
+    const TagNumber* groupMembers_;
+    const TagNumber* sparseNumbers_{}; // The tag numbers from denseTagLimit, sorted
+    const SpecField* sparseFields_{};  // The fields of sparseNumbers_, in the same order
+    std::size_t sparseCount_{};
+    const FieldInfo* infos_{};          // Packed fields_ then sparseFields_, read as is by the dictionary. nullptr to have them computed
+    const std::string_view* enums_{};   // The enum values infos_ refer to
+
+    constexpr auto field(TagNumber number) const noexcept -> const SpecField* {
+
+        if( number < denseTagLimit ){
+            return number <= maxNumber_ && !fields_[number].name_.empty() ? &fields_[number] : nullptr;
+        }
 
-    for(auto& child: groupNode.children()){
+        std::size_t first{0};
 
-      if (std::strcmp("component", child.name()) == 0) {
-        return processComponent(child.attribute("name").as_string(),
-                                std::forward<M>(message));
-      } else {
-        auto isFieldPresent = std::find_if(
-            message.body_.tagValues_.begin(), message.body_.tagValues_.end(),
-            [&child](auto& tag) {
-              return tag.name_ == child.attribute("name").as_string();
-            });
+        for(auto count = sparseCount_; count != 0; ){
 
-        if (isFieldPresent == message.body_.tagValues_.end()) {
-          std::string errMsg = "BODY: the tag with name=";
-          errMsg += child.attribute("name").as_string();
-          errMsg += " is required";
+            auto half = count / 2;
 
-          errorBag.errors_.emplace_back(Error{std::move(errMsg)});
-          hasRequired = false;
+            if( sparseNumbers_[first + half] < number ){
+                first += half + 1;
+                count -= half + 1;
+            }
+            else{
+                count = half;
+            }
         }
-      }
+
+        return first != sparseCount_ && sparseNumbers_[first] == number ? &sparseFields_[first] : nullptr;
     }
 
-    return hasRequired;
-}
-/**
- * @brief Process the given component for required fields checks
- * @return true if the message has the necessary required fields by the component, false otherwise
- **/
-template<typename T, typename M>
-constexpr auto processComponent(T&& compName, M&& message) -> bool{
-    auto component = fixSpec.child("fix")
-                            .child("components")
-                            .find_child_by_attribute("component","name", compName );
-    
-    bool hasRequired{1};
+    constexpr auto number(std::string_view name) const noexcept -> TagNumber {
 
-    for(auto& componentField: component.children() ){
-        if( std::strcmp( componentField.attribute("required").as_string(), "Y") == 0 ){
-            
-            if( std::strcmp("component", componentField.name() ) == 0 ) {
-                
-                return processComponent(componentField.attribute("name").as_string(), std::forward<M>(message));
+        if( name.empty() ){
+            return 0;
+        }
+
+        for(TagNumber number{0}; number <= maxNumber_; ++number ){
+            if( fields_[number].name_ == name ){
+                return number;
             }
-            else if( std::strcmp("group", componentField.name()) == 0 ) {
-                return processGroup(componentField, std::forward<M>(message) );
-            }else{
+        }
 
-                auto isFieldPresent = std::find_if( message.body_.tagValues_.begin(),
-                                                    message.body_.tagValues_.end(),
-                                                    [&componentField](auto& tag){
-                                                        return tag.name_ == componentField.attribute("name").as_string();
-                                                   });
+        for(std::size_t i{0}; i != sparseCount_; ++i ){
+            if( sparseFields_[i].name_ == name ){
+                return sparseNumbers_[i];
+            }
+        }
+
+        return 0;
+    }
 
-                if( isFieldPresent == message.body_.tagValues_.end() ){
-                    std::string errMsg = "BODY: the tag with name=";
-                                errMsg += componentField.attribute("name").as_string();
-                                errMsg += " is required";
+    constexpr auto message(std::string_view msgType) const noexcept -> const SpecMessage* {
 
-                    errorBag.errors_.emplace_back( Error{std::move(errMsg)} );
-                    hasRequired = false;
-                }                                   
+        for(std::size_t i{0}; i != messageCount_; ++i ){
+            if( messages_[i].msgType_ == msgType ){
+                return &messages_[i];
             }
         }
+
+        return nullptr;
     }
+};
 
-    return hasRequired;
-}
 /**
- * @brief Check for required fields in the message
- * @return true if the message has required fields, false otherwise
-*/
-template <typename T,typename=std::enable_if_t<std::is_same_v<std::decay_t<T>, FixMessage> > >
-constexpr auto hasRequiredFields(T&& message) noexcept -> bool{
-
-    auto headerFields = fixSpec.child("fix").child("header").children();
-    auto trailerFields = fixSpec.child("fix").child("trailer").children();
+ * @brief A MsgType of up to 8 characters packed in an integer, the first character in the high byte
+ * @return the packed MsgType or 0 if it's empty or longer
+ **/
+constexpr auto packMsgType(std::string_view msgType) noexcept -> std::uint64_t {
 
-    bool hasRequired{true};
-    std::string msgType{};
+    if( msgType.empty() || msgType.size() > 8 ){
+        return 0;
+    }
 
-    // Check for required fields in the header
-    for(const auto& child: headerFields ){
+    std::uint64_t key{};
 
-        if( std::strcmp( child.attribute("required").as_string(), "Y") == 0 ){
+    for(auto c: msgType ){
+        key = ( key << 8 ) | static_cast<unsigned char>( c );
+    }
 
-            // Check if the field is present in the header
-            auto isFieldPresent = std::find_if( message.header_.headerFields_.begin(),
-                                                message.header_.headerFields_.end(),
-                                                [&child](auto& field){
-                                                    return field.name_ == child.attribute("name").as_string();
-                                                });
+    return key;
+}
 
-            if( isFieldPresent == message.header_.headerFields_.end() ){
-                std::string errMsg = "HEADER: the tag with name=";
-                            errMsg += child.attribute("name").as_string();
-                            errMsg += " is required";
+/**
+ * @brief Compiled form of a FIX specification file.
+ * It's built once from the XML and then only queried, every lookup by tag number is a direct index.
+ **/
+class Dictionary{
 
-                errorBag.errors_.emplace_back( Error{std::move(errMsg)} );
-                hasRequired = false;
-            }else{
+    public:
 
-            // We retrieve and store the message type at this level
-                auto f = *isFieldPresent;
+        Dictionary() = default;
 
-                if( f.number_ == 35 ){
-                    msgType = f.value_;
-                }
-            }
+        // The packed tables refer to the dictionary's own buffers
+        Dictionary(const Dictionary&) = delete;
+        Dictionary& operator=(const Dictionary&) = delete;
 
+        /**
+         * @brief Build a dictionary from the XML specification located at path
+         * @return the dictionary or nullptr if the file cannot be loaded
+         **/
+#ifndef FIXPARSER_NO_PUGIXML
+        static auto fromFile(const fs::path& path) -> std::shared_ptr<const Dictionary> {
+            return fromFiles( { path } );
         }
-    }
 
-    // Check the required fields in the body
-    // NOTE: There are some conditional required fields, not dealing with them as of now
-    // NOTE: Some required fields depends on the message type tag 35=MsgType
+        /**
+         * @brief Build a dictionary from a base specification and extensions merged on top of it, in order.
+         * An extension adds fields, enum values, components, messages and header or trailer fields. A field it defines
+         * again takes its name and type, a message or a component it defines again gets its fields appended
+         * @return the dictionary or nullptr if one of the files cannot be loaded
+         **/
+        static auto fromFiles(const std::vector<fs::path>& paths) -> std::shared_ptr<const Dictionary> {
 
-    auto isCorrectMsgType = fixSpec.child("fix")
-                                   .child("messages")
-                                   .find_child_by_attribute("message","msgtype", msgType.c_str() );
+            std::vector<pugi::xml_document> specs( paths.size() );
+            std::vector<pugi::xml_node> fixes;
 
-    if( !isCorrectMsgType ){
-        std::string errMsg("The message type is invalid");
+            for(std::size_t i{0}; i != paths.size(); ++i ){
 
-        errorBag.errors_.emplace_back( Error{std::move(errMsg)} );
-        hasRequired = false;
-    }else{
+                if( !specs[i].load_file( paths[i].c_str() ) ){
+                    return nullptr;
+                }
 
-        // We can now check for required fields for the specified message
-        // @TODO: Deal with the case of required components
+                fixes.emplace_back( specs[i].child("fix") );
+            }
 
-        auto msgField = std::move(isCorrectMsgType);
+            if( fixes.empty() ){
+                return nullptr;
+            }
 
-        for(const auto& child: msgField.children() ){
+            auto dictionary = std::make_shared<Dictionary>();
+            dictionary->build( fixes );
 
-            if( std::strcmp( child.attribute("required").as_string(), "Y") == 0 ){
-                
-                // @TODO use tag dispatcher instead of if-else
-                // Check if the field is present in the body
-            
-                if( std::strcmp("component", child.name() ) == 0 ){
+            return dictionary;
+        }
+#endif
 
-                    hasRequired = processComponent( child.attribute("name").as_string(), std::forward<T>(message) );
-                                           
-                }else if( std::strcmp("group", child.name()) == 0 ){
+        /**
+         * @brief Build a dictionary from tables generated at build time, no file is read
+         **/
+        static auto fromTables(const SpecTables& tables) -> std::shared_ptr<const Dictionary> {
 
-                    hasRequired = processGroup(child, std::forward<T>(message) );
+            auto dictionary = std::make_shared<Dictionary>();
+            dictionary->build( tables );
 
-                }else{
+            return dictionary;
+        }
 
-                    auto isFieldPresent = std::find_if( message.body_.tagValues_.begin(),
-                                                        message.body_.tagValues_.end(),
-                                                        [&child](auto& tag){
-                                                            return tag.name_ == child.attribute("name").as_string();
-                                                        });
+        auto field(TagNumber number) const noexcept -> const FieldDef* {
 
-                    if( isFieldPresent == message.body_.tagValues_.end() ){
-                        std::string errMsg = "BODY: the tag with name=";
-                                    errMsg += child.attribute("name").as_string();
-                                    errMsg += " is required";
+            auto slot = slotOf( number );
 
-                        errorBag.errors_.emplace_back( Error{std::move(errMsg)} );
-                        hasRequired = false;
-                    }
+            if( slot == noSlot || !fields_[slot].isDefined_ ){
+                return nullptr;
+            }
 
-                }
+            return &fields_[slot];
+        }
+
+        /**
+         * @brief The packed description of a field, the one to use while validating
+         * @return the description, with isDefined_ false if the dictionary has no such field
+         **/
+        auto info(TagNumber number) const noexcept -> FieldInfo {
 
+            if( number < denseCount_ ){
+                return infoTable_[number];
             }
+
+            auto slot = slotOf( number );
+            return slot != noSlot ? infoTable_[slot] : FieldInfo{};
         }
 
-    }
+        /**
+         * @brief Find the definition of a MsgType, by its packed form in a sorted array of integers
+         * @return the definition or nullptr if the specification has no such MsgType
+         **/
+        auto message(std::string_view msgType) const noexcept -> const MessageDef* {
 
-    // Check the required fields for the trailer
+            auto key = packMsgType( msgType );
 
-    for(const auto& child: trailerFields ){
+            // The MsgTypes too long to be packed aren't in the index, there are few if any
+            if( key == 0 ){
 
-        if( std::strcmp( child.attribute("required").as_string(), "Y") == 0 ){
+                auto found = std::find_if( messages_.begin(), messages_.end(), [msgType](const auto& msgDef){
+                                               return msgDef.msgType_ == msgType;
+                                           });
 
-            // Check if the field is present in the trailer
-            auto isFieldPresent = std::find_if( message.trailer_.trailer_.begin(),
-                                                message.trailer_.trailer_.end(),
-                                                [&child](auto& field){
-                                                    return field.name_ == child.attribute("name").as_string();
-                                                });
+                return found == messages_.end() ? nullptr : &*found;
+            }
 
-            if( isFieldPresent == message.trailer_.trailer_.end() ){
-                std::string errMsg = "TRAILER: the tag with name=";
-                            errMsg += child.attribute("name").as_string();
-                            errMsg += " is required";
+            auto found = std::lower_bound( messageKeys_.begin(), messageKeys_.end(), key );
 
-                errorBag.errors_.emplace_back( Error{std::move(errMsg)} );
-                hasRequired = false;
+            if( found == messageKeys_.end() || *found != key ){
+                return nullptr;
             }
 
+            return &messages_[ messageIndexes_[ found - messageKeys_.begin() ] ];
         }
-    }
 
-    return hasRequired;
-}
+        /**
+         * @brief Find the number of a field from its name
+         * @return the tag number or 0 if there's no such field
+         **/
+        auto number(std::string_view name) const noexcept -> TagNumber {
 
+            if( auto found = numbers_.find( name ); found != numbers_.end() ){
+                return found->second;
+            }
 
-/**
- * @brief Check the message body length
- * @return true if the body length is correct false otherwise
+            return 0;
+        }
+
+        /**
+         * @brief Find the enum entry of a field matching value
+         * @return the enum entry or nullptr if the field has no such value
+         **/
+        auto enumValue(TagNumber number, std::string_view value) const noexcept -> const Value* {
+
+            auto fieldInfo = info( number );
+
+            for(std::uint32_t i{0}; i != fieldInfo.valueCount_; ++i ){
+                if( enumTable_[fieldInfo.firstValue_ + i] == value ){
+                    return &fields_[slotOf( number )].values_[i];
+                }
+            }
+
+            return nullptr;
+        }
+
+        /**
+         * @brief Same as enumValue() != nullptr, only reading the packed tables
+         **/
+        auto isEnumValue(TagNumber number, std::string_view value) const noexcept -> bool {
+
+            auto fieldInfo = info( number );
+            auto first = enumTable_ + fieldInfo.firstValue_;
+
+            return std::find( first, first + fieldInfo.valueCount_, value ) != first + fieldInfo.valueCount_;
+        }
+
+        auto headerRequired() const noexcept -> const TagSet& {
+            return headerRequired_;
+        }
+
+        auto trailerRequired() const noexcept -> const TagSet& {
+            return trailerRequired_;
+        }
+
+        /**
+         * @brief The required fields of the header and the trailer, those of every message whatever its type
+         **/
+        auto sessionRequired() const noexcept -> const TagSet& {
+            return sessionRequired_;
+        }
+
+        auto messages() const noexcept -> const std::vector<MessageDef>& {
+            return messages_;
+        }
+
+        /**
+         * @brief The highest tag number defined by the specification
+         **/
+        auto maxNumber() const noexcept -> TagNumber {
+
+            if( !sparseNumbers_.empty() ){
+                return sparseNumbers_.back();
+            }
+
+            return denseCount_ == 0 ? 0 : static_cast<TagNumber>( denseCount_ - 1 );
+        }
+
+        /**
+         * @brief The tag numbers from denseTagLimit defined by the specification, sorted
+         **/
+        auto sparseNumbers() const noexcept -> const std::vector<TagNumber>& {
+            return sparseNumbers_;
+        }
+
+    private:
+
+        auto build(const SpecTables& tables) -> void {
+
+            std::vector<std::pair<TagNumber, const SpecField*>> entries;
+
+            for(TagNumber number{0}; number <= tables.maxNumber_; ++number ){
+                if( !tables.fields_[number].name_.empty() ){
+                    entries.emplace_back( number, &tables.fields_[number] );
+                }
+            }
+
+            for(std::size_t i{0}; i != tables.sparseCount_; ++i ){
+                entries.emplace_back( tables.sparseNumbers_[i], &tables.sparseFields_[i] );
+            }
+
+            std::vector<TagNumber> numbers;
+
+            for(const auto& [number, entry]: entries ){
+                numbers.emplace_back( number );
+            }
+
+            layout( numbers );
+
+            for(const auto& [number, spec]: entries ){
+
+                const auto& entry = *spec;
+                auto& fieldDef = fieldAt( number );
+
+                fieldDef.name_ = entry.name_;
+                fieldDef.type_ = entry.type_;
+                fieldDef.kind_ = toFieldKind( fieldDef.type_ );
+                fieldDef.placement_ = entry.placement_;
+                fieldDef.isDefined_ = true;
+
+                for(auto i = entry.values_.begin_; i != entry.values_.begin_ + entry.values_.count_; ++i ){
+                    fieldDef.values_.emplace_back( Value{ std::string( tables.values_[i].enumValue_ ),
+                                                          std::string( tables.values_[i].description_ ) } );
+                }
+
+                numbers_.emplace( fieldDef.name_, number );
+            }
+
+            auto requiredSet = [&tables](const SpecRange& range){
+
+                TagSet required( tables.maxNumber_ );
+
+                for(auto i = range.begin_; i != range.begin_ + range.count_; ++i ){
+                    required.insert( tables.required_[i] );
+                }
+
+                return required;
+            };
+
+            headerRequired_ = requiredSet( tables.headerRequired_ );
+            trailerRequired_ = requiredSet( tables.trailerRequired_ );
+
+            sessionRequired_ = headerRequired_;
+            sessionRequired_ |= trailerRequired_;
+
+            for(std::size_t i{0}; i != tables.messageCount_; ++i ){
+
+                const auto& entry = tables.messages_[i];
+
+                MessageDef msgDef;
+                msgDef.msgName_ = entry.msgName_;
+                msgDef.msgType_ = entry.msgType_;
+                msgDef.msgCat_ = entry.msgCat_;
+                msgDef.requiredFields_ = requiredSet( entry.requiredFields_ );
+
+                for(auto g = entry.groups_.begin_; g != entry.groups_.begin_ + entry.groups_.count_; ++g ){
+
+                    const auto& group = tables.groups_[g];
+
+                    GroupDef groupDef;
+                    groupDef.countTag_ = group.countTag_;
+                    groupDef.parent_ = group.parent_;
+                    groupDef.members_.assign( tables.groupMembers_ + group.members_.begin_,
+                                              tables.groupMembers_ + group.members_.begin_ + group.members_.count_ );
+
+                    msgDef.groups_.emplace_back( std::move(groupDef) );
+                }
+
+                addMessage( std::move(msgDef) );
+            }
+
+            // Tables generated by fixgen come with the packed fields, the dictionary reads them in place
+            if( tables.infos_ && tables.enums_ && denseCount_ == tables.maxNumber_ + std::size_t{1} ){
+                infoTable_ = tables.infos_;
+                enumTable_ = tables.enums_;
+            }
+            else{
+                packFields();
+            }
+
+            indexMessages();
+        }
+
+        // The required set of a message is checked along with those of the header and the trailer
+        auto addMessage(MessageDef&& msgDef) -> void {
+
+            msgDef.allRequired_ = msgDef.requiredFields_;
+            msgDef.allRequired_ |= sessionRequired_;
+
+            // The lookups used while decoding are derived from the members and the parent of each group
+            for(std::size_t i{0}; i != msgDef.groups_.size(); ++i ){
+
+                auto& groupDef = msgDef.groups_[i];
+
+                groupDef.nested_.assign( groupDef.members_.size(), -1 );
+                groupDef.slots_.clear();
+
+                for(std::size_t slot{0}; slot != groupDef.members_.size(); ++slot ){
+                    groupDef.slots_.emplace_back( groupDef.members_[slot], static_cast<std::uint16_t>( slot ) );
+                }
+
+                std::sort( groupDef.slots_.begin(), groupDef.slots_.end() );
+
+                if( groupDef.parent_ < 0 ){
+                    msgDef.groupCounts_.insert( groupDef.countTag_ );
+                }
+            }
+
+            for(std::size_t i{0}; i != msgDef.groups_.size(); ++i ){
+
+                const auto& groupDef = msgDef.groups_[i];
+
+                if( groupDef.parent_ >= 0 ){
+
+                    auto& parent = msgDef.groups_[groupDef.parent_];
+
+                    if( auto slot = parent.slot( groupDef.countTag_ ); slot >= 0 ){
+                        parent.nested_[slot] = static_cast<std::int32_t>( i );
+                    }
+                }
+            }
+
+            // The first definition of a MsgType is kept
+            auto known = std::find_if( messages_.begin(), messages_.end(), [&msgDef](const auto& other){
+                                           return other.msgType_ == msgDef.msgType_;
+                                       });
+
+            if( known == messages_.end() ){
+                messages_.emplace_back( std::move(msgDef) );
+            }
+        }
+
+        // Copy what the validation reads into contiguous tables, once the fields are complete.
+        // The enum values of every field are laid out one after the other in a single buffer
+        auto packFields() -> void {
+
+            std::size_t poolSize{};
+
+            for(const auto& fieldDef: fields_ ){
+                for(const auto& value: fieldDef.values_ ){
+                    poolSize += value.enumValue_.size();
+                }
+            }
+
+            enumPool_.reserve( poolSize );
+            infos_.assign( fields_.size(), FieldInfo{} );
+
+            std::vector<std::pair<std::size_t, std::size_t>> ranges;
+
+            for(std::size_t slot{0}; slot != fields_.size(); ++slot ){
+
+                const auto& fieldDef = fields_[slot];
+                auto& fieldInfo = infos_[slot];
+
+                fieldInfo.firstValue_ = static_cast<std::uint32_t>( ranges.size() );
+                fieldInfo.valueCount_ = static_cast<std::uint16_t>( std::min<std::size_t>( fieldDef.values_.size(), UINT16_MAX ) );
+                fieldInfo.kind_ = fieldDef.kind_;
+                fieldInfo.placement_ = fieldDef.placement_;
+                fieldInfo.isDefined_ = fieldDef.isDefined_;
+                fieldInfo.isMultipleValue_ = fieldDef.type_ == "MULTIPLEVALUESTRING";
+
+                for(std::size_t i{0}; i != fieldInfo.valueCount_; ++i ){
+                    ranges.emplace_back( enumPool_.size(), fieldDef.values_[i].enumValue_.size() );
+                    enumPool_ += fieldDef.values_[i].enumValue_;
+                }
+            }
+
+            // The views are taken once the buffer is complete, it's never modified afterwards
+            enums_.clear();
+
+            for(const auto& [offset, size]: ranges ){
+                enums_.emplace_back( enumPool_.data() + offset, size );
+            }
+
+            infoTable_ = infos_.data();
+            enumTable_ = enums_.data();
+        }
+
+        // Sort the packed MsgTypes for the lookups by message()
+        auto indexMessages() -> void {
+
+            std::vector<std::pair<std::uint64_t, std::uint32_t>> index;
+
+            for(std::size_t i{0}; i != messages_.size(); ++i ){
+                if( auto key = packMsgType( messages_[i].msgType_ ); key != 0 ){
+                    index.emplace_back( key, static_cast<std::uint32_t>( i ) );
+                }
+            }
+
+            std::sort( index.begin(), index.end() );
+
+            messageKeys_.clear();
+            messageIndexes_.clear();
+
+            for(const auto& [key, i]: index ){
+                messageKeys_.emplace_back( key );
+                messageIndexes_.emplace_back( i );
+            }
+        }
+
+#ifndef FIXPARSER_NO_PUGIXML
+        // The specs are the base one followed by its extensions, every section is read from all of them in order
+        auto build(const std::vector<pugi::xml_node>& specs) -> void {
+
+            std::vector<TagNumber> numbers;
+
+            for(const auto& fix: specs ){
+                for(const auto& node: fix.child("fields").children("field") ){
+                    numbers.emplace_back( node.attribute("number").as_uint() );
+                }
+            }
+
+            layout( numbers );
+
+            auto maxNumber = this->maxNumber();
+
+            for(const auto& fix: specs ){
+
+                for(const auto& node: fix.child("fields").children("field") ){
+
+                    auto number = static_cast<TagNumber>( node.attribute("number").as_uint() );
+                    auto& fieldDef = fieldAt( number );
+
+                    fieldDef.name_ = node.attribute("name").as_string();
+                    fieldDef.type_ = node.attribute("type").as_string();
+                    fieldDef.kind_ = toFieldKind( fieldDef.type_ );
+                    fieldDef.isDefined_ = true;
+
+                    for(const auto& value: node.children("value") ){
+
+                        std::string enumValue = value.attribute("enum").as_string();
+
+                        auto known = std::find_if( fieldDef.values_.begin(), fieldDef.values_.end(),
+                                                   [&enumValue](const auto& v){ return v.enumValue_ == enumValue; } );
+
+                        if( known == fieldDef.values_.end() ){
+                            fieldDef.values_.emplace_back( Value{ std::move(enumValue), value.attribute("description").as_string() } );
+                        }
+                    }
+
+                    numbers_[fieldDef.name_] = number;
+                }
+            }
+
+            headerRequired_ = TagSet( maxNumber );
+            trailerRequired_ = TagSet( maxNumber );
+
+            for(const auto& fix: specs ){
+                placeSection( fix.child("header"), Placement::HEADER );
+                placeSection( fix.child("trailer"), Placement::TRAILER );
+
+                collectRequired( specs, fix.child("header"), headerRequired_ );
+                collectRequired( specs, fix.child("trailer"), trailerRequired_ );
+            }
+
+            sessionRequired_ = headerRequired_;
+            sessionRequired_ |= trailerRequired_;
+
+            // The definitions of a message found in every spec, in the order the messages are first met
+            std::vector<std::pair<std::string, std::vector<pugi::xml_node>>> definitions;
+
+            for(const auto& fix: specs ){
+                for(const auto& node: fix.child("messages").children("message") ){
+
+                    std::string msgType = node.attribute("msgtype").as_string();
+
+                    auto known = std::find_if( definitions.begin(), definitions.end(),
+                                               [&msgType](const auto& definition){ return definition.first == msgType; } );
+
+                    if( known == definitions.end() ){
+                        known = definitions.insert( known, { std::move(msgType), {} } );
+                    }
+
+                    known->second.emplace_back( node );
+                }
+            }
+
+            for(const auto& [msgType, nodes]: definitions ){
+
+                MessageDef msgDef;
+                msgDef.msgName_ = nodes.front().attribute("name").as_string();
+                msgDef.msgType_ = msgType;
+                msgDef.msgCat_ = nodes.front().attribute("msgcat").as_string();
+                msgDef.requiredFields_ = TagSet( maxNumber );
+
+                for(const auto& fix: specs ){
+                    collectGroups( specs, fix.child("header"), msgDef, -1 );
+                }
+
+                for(const auto& node: nodes ){
+                    collectRequired( specs, node, msgDef.requiredFields_ );
+                    collectGroups( specs, node, msgDef, -1 );
+                }
+
+                for(const auto& fix: specs ){
+                    collectGroups( specs, fix.child("trailer"), msgDef, -1 );
+                }
+
+                addMessage( std::move(msgDef) );
+            }
+
+            packFields();
+            indexMessages();
+        }
+
+        // Call f with every definition of the component referred to by node, the base one first
+        template <typename F>
+        static auto forEachComponent(const std::vector<pugi::xml_node>& specs, const pugi::xml_node& node, F&& f) -> void {
+
+            auto name = node.attribute("name").as_string();
+
+            for(const auto& fix: specs ){
+                if( auto component = fix.child("components").find_child_by_attribute("component", "name", name ) ){
+                    f( component );
+                }
+            }
+        }
+
+        // Every field appearing in the header (or the trailer), groups included, gets the section placement
+        auto placeSection(const pugi::xml_node& section, Placement placement) -> void {
+
+            for(const auto& child: section.children() ){
+
+                if( auto number = this->number( child.attribute("name").as_string() ); number != 0 ){
+                    fieldAt( number ).placement_ = placement;
+                }
+
+                if( std::strcmp("group", child.name()) == 0 ){
+                    placeSection( child, placement );
+                }
+            }
+        }
+
+        // Flatten the required fields of a node, following required components and groups
+        auto collectRequired(const std::vector<pugi::xml_node>& specs, const pugi::xml_node& node, TagSet& required) -> void {
+
+            for(const auto& child: node.children() ){
+
+                if( std::strcmp( child.attribute("required").as_string(), "Y") != 0 ){
+                    continue;
+                }
+
+                if( std::strcmp("component", child.name() ) == 0 ){
+
+                    forEachComponent( specs, child, [&](const pugi::xml_node& component){
+                        collectRequired( specs, component, required );
+                    });
+
+                }else{
+
+                    // For a group the field holding the number of entries is the required one
+                    if( auto number = this->number( child.attribute("name").as_string() ); number != 0 ){
+                        required.insert( number );
+                    }
+
+                    if( std::strcmp("group", child.name()) == 0 ){
+                        collectRequired( specs, child, required );
+                    }
+                }
+            }
+        }
+
+        // Append the groups found in node to the message, the fields of node are members of the parent group if any
+        auto collectGroups(const std::vector<pugi::xml_node>& specs, const pugi::xml_node& node, MessageDef& msgDef, std::int32_t parent) -> void {
+
+            for(const auto& child: node.children() ){
+
+                if( std::strcmp("component", child.name() ) == 0 ){
+
+                    forEachComponent( specs, child, [&](const pugi::xml_node& component){
+                        collectGroups( specs, component, msgDef, parent );
+                    });
+
+                    continue;
+                }
+
+                auto number = this->number( child.attribute("name").as_string() );
+
+                if( number == 0 ){
+                    continue;
+                }
+
+                if( parent >= 0 ){
+
+                    auto& members = msgDef.groups_[parent].members_;
+
+                    if( std::find( members.begin(), members.end(), number ) == members.end() ){
+                        members.emplace_back( number );
+                    }
+                }
+
+                if( std::strcmp("group", child.name()) == 0 ){
+
+                    // A group met again, from an extension, gets the new members
+                    auto known = std::find_if( msgDef.groups_.begin(), msgDef.groups_.end(), [number, parent](const auto& groupDef){
+                                                   return groupDef.countTag_ == number && groupDef.parent_ == parent;
+                                               });
+
+                    if( known == msgDef.groups_.end() ){
+
+                        GroupDef groupDef;
+                        groupDef.countTag_ = number;
+                        groupDef.parent_ = parent;
+
+                        known = msgDef.groups_.insert( known, std::move(groupDef) );
+                    }
+
+                    collectGroups( specs, child, msgDef, static_cast<std::int32_t>( known - msgDef.groups_.begin() ) );
+                }
+            }
+        }
+#endif
+
+        static constexpr std::size_t noSlot{ static_cast<std::size_t>( -1 ) };
+
+        // Size fields_ for the defined tag numbers: those below denseTagLimit are indexes,
+        // the larger ones follow in the order of sparseNumbers_
+        auto layout(std::vector<TagNumber> numbers) -> void {
+
+            std::sort( numbers.begin(), numbers.end() );
+            numbers.erase( std::unique( numbers.begin(), numbers.end() ), numbers.end() );
+
+            auto sparse = std::lower_bound( numbers.begin(), numbers.end(), denseTagLimit );
+
+            denseCount_ = sparse == numbers.begin() ? 0 : std::size_t{ *( sparse - 1 ) } + 1;
+            sparseNumbers_.assign( sparse, numbers.end() );
+            fields_.assign( denseCount_ + sparseNumbers_.size(), FieldDef{} );
+        }
+
+        // Index in fields_ and infos_ of a tag number, noSlot if it's beyond the specification
+        auto slotOf(TagNumber number) const noexcept -> std::size_t {
+
+            if( number < denseTagLimit ){
+                return number < denseCount_ ? number : noSlot;
+            }
+
+            auto found = std::lower_bound( sparseNumbers_.begin(), sparseNumbers_.end(), number );
+
+            if( found == sparseNumbers_.end() || *found != number ){
+                return noSlot;
+            }
+
+            return denseCount_ + static_cast<std::size_t>( found - sparseNumbers_.begin() );
+        }
+
+        // Only for the numbers given to layout
+        auto fieldAt(TagNumber number) -> FieldDef& {
+            return fields_[slotOf( number )];
+        }
+
+        std::vector<FieldDef> fields_;        // Indexed by tag number up to denseCount_, then the fields of sparseNumbers_
+        std::vector<FieldInfo> infos_;        // Laid out like fields_
+        const FieldInfo* infoTable_{};        // infos_ or the generated tables the dictionary was built from
+        const std::string_view* enumTable_{}; // Likewise enums_ or the generated ones
+        std::size_t denseCount_{};
+        std::vector<TagNumber> sparseNumbers_;
+        std::vector<std::string_view> enums_; // The enum values of every field, in enumPool_
+        std::string enumPool_;
+        std::vector<MessageDef> messages_;             // Never resized once built, the lookups return pointers into it
+        std::vector<std::uint64_t> messageKeys_;      // The packed MsgTypes, sorted
+        std::vector<std::uint32_t> messageIndexes_;   // Index in messages_ of each key of messageKeys_
+        std::map<std::string, TagNumber, std::less<>> numbers_; // Only used while building and by the cold lookups by name
+        TagSet headerRequired_;
+        TagSet trailerRequired_;
+        TagSet sessionRequired_;
+};
+
+// Fixed-point decimal worth mantissa_ / 10^scale_, e.g 100.25 is { 10025, 2 }
+struct Decimal{
+    std::int64_t mantissa_{};
+    std::uint8_t scale_{};
+
+    auto toDouble() const noexcept -> double {
+
+        double value = static_cast<double>( mantissa_ );
+
+        for(auto i = scale_; i != 0; --i ){
+            value /= 10;
+        }
+
+        return value;
+    }
+};
+
+/**
+ * @brief Parse an unsigned decimal number made of digits only
+ * @return true if str is a valid number, false otherwise
+ **/
+[[nodiscard]] constexpr auto toUnsigned(std::string_view str, std::uint32_t& number) noexcept -> bool {
+
+    if( str.empty() || str.size() > 9 ){
+        return false;
+    }
+
+    number = 0;
+
+    for(auto c: str ){
+        if( c < '0' || c > '9' ){
+            return false;
+        }
+        number = number * 10 + static_cast<std::uint32_t>( c - '0' );
+    }
+
+    return true;
+}
+
+/**
+ * @brief Parse a signed decimal integer, e.g -42
+ * @return true if str is a valid integer of at most 18 digits, false otherwise
+ **/
+[[nodiscard]] constexpr auto parseInt(std::string_view str, std::int64_t& number) noexcept -> bool {
+
+    bool isNegative = !str.empty() && str.front() == '-';
+
+    if( isNegative ){
+        str.remove_prefix( 1 );
+    }
+
+    if( str.empty() || str.size() > 18 ){
+        return false;
+    }
+
+    number = 0;
+
+    for(auto c: str ){
+        if( c < '0' || c > '9' ){
+            return false;
+        }
+        number = number * 10 + ( c - '0' );
+    }
+
+    number = isNegative ? -number : number;
+    return true;
+}
+
+/**
+ * @brief Parse a decimal number with an optional fraction, e.g -100.25, without going through a double
+ * @return true if str is a valid number of at most 18 digits, false otherwise
+ **/
+[[nodiscard]] constexpr auto parseDecimal(std::string_view str, Decimal& decimal) noexcept -> bool {
+
+    bool isNegative = !str.empty() && str.front() == '-';
+
+    if( isNegative ){
+        str.remove_prefix( 1 );
+    }
+
+    std::int64_t mantissa{};
+    std::size_t digits{};
+    std::size_t scale{};
+    bool hasPoint{};
+
+    for(auto c: str ){
+
+        if( c == '.' && !hasPoint ){
+            hasPoint = true;
+            continue;
+        }
+
+        if( c < '0' || c > '9' || ++digits > 18 ){
+            return false;
+        }
+
+        mantissa = mantissa * 10 + ( c - '0' );
+        scale += hasPoint;
+    }
+
+    if( digits == 0 ){
+        return false;
+    }
+
+    decimal.mantissa_ = isNegative ? -mantissa : mantissa;
+    decimal.scale_ = static_cast<std::uint8_t>( scale );
+    return true;
+}
+
+/**
+ * @brief Parse a UTCTIMESTAMP, YYYYMMDD-HH:MM:SS with an optional fraction of second of up to 9 digits
+ * @param nanoseconds the number of nanoseconds since the epoch
+ * @return true if str is a valid timestamp, false otherwise
+ **/
+[[nodiscard]] constexpr auto parseTimestamp(std::string_view str, std::int64_t& nanoseconds) noexcept -> bool {
+
+    if( str.size() < 17 || str[8] != '-' || str[11] != ':' || str[14] != ':' ){
+        return false;
+    }
+
+    auto digits = [str](std::size_t pos, std::size_t count, std::int64_t& value){
+
+        value = 0;
+
+        for(auto i = pos; i != pos + count; ++i ){
+            if( str[i] < '0' || str[i] > '9' ){
+                return false;
+            }
+            value = value * 10 + ( str[i] - '0' );
+        }
+
+        return true;
+    };
+
+    std::int64_t year{}, month{}, day{}, hour{}, minute{}, second{};
+
+    if( !digits( 0, 4, year ) || !digits( 4, 2, month ) || !digits( 6, 2, day ) ||
+        !digits( 9, 2, hour ) || !digits( 12, 2, minute ) || !digits( 15, 2, second ) ){
+        return false;
+    }
+
+    bool isLeapYear = ( year % 4 == 0 && year % 100 != 0 ) || year % 400 == 0;
+    std::int64_t monthDays[] = { 31, isLeapYear ? 29 : 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    // 60 seconds for the leap seconds
+    if( month < 1 || month > 12 || day < 1 || day > monthDays[month - 1] || hour > 23 || minute > 59 || second > 60 ){
+        return false;
+    }
+
+    std::int64_t fraction{};
+
+    if( str.size() > 17 ){
+
+        auto fractionDigits = str.size() - 18;
+
+        if( str[17] != '.' || fractionDigits == 0 || fractionDigits > 9 || !digits( 18, fractionDigits, fraction ) ){
+            return false;
+        }
+
+        for(auto i = fractionDigits; i != 9; ++i ){
+            fraction *= 10;
+        }
+    }
+
+    // Days since 1970-01-01 of the civil date, the year starting in March so that the leap day comes last
+    year -= month <= 2;
+    auto era = year / 400;
+    auto yearOfEra = year - era * 400;
+    auto dayOfYear = ( 153 * ( month > 2 ? month - 3 : month + 9 ) + 2 ) / 5 + day - 1;
+    auto dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    auto days = era * 146097 + dayOfEra - 719468;
+
+    nanoseconds = ( ( days * 24 + hour ) * 60 + minute ) * 60 + second;
+    nanoseconds = nanoseconds * 1000000000 + fraction;
+    return true;
+}
+
+/**
+ * @brief A repeating group decoded from a message.
+ * Its entries are rows of FixMessage::slots_ with one column per member of the group, each slot holding
+ * the index in FixMessage::fields_ of the member in that entry
+ **/
+struct GroupRef{
+    static constexpr std::uint32_t noParent = UINT32_MAX;
+
+    const GroupDef* groupDef_{};
+    std::uint32_t countField_{};       // Index in FixMessage::fields_ of the NumInGroup field
+    std::uint32_t entryCount_{};
+    std::uint32_t firstSlot_{};        // Index in FixMessage::slots_ of the first slot of the first entry
+    std::uint32_t parent_{noParent};   // Index in FixMessage::groups_ of the enclosing group
+    std::uint32_t parentEntry_{};      // Entry of the enclosing group holding this group
+};
+
+/**
+ * @brief A parsed FIX message.
+ * The fields are kept in the order of the raw message and only refer to it, the names, types and enum
+ * descriptions are looked up in the dictionary when asked for. The raw message must outlive it
+ **/
+struct FixMessage{
+    static constexpr std::uint32_t noField = UINT32_MAX;
+
+    std::string_view rawMsg_;
+    std::pmr::vector<FieldRef> fields_;
+    const Dictionary* dictionary_{};
+    std::pmr::vector<GroupRef> groups_;      // Filled by decodeGroups(), a group comes before the groups nested in it
+    std::pmr::vector<std::uint32_t> slots_;  // The entries of every group, noField where an entry lacks a member
+
+    FixMessage() = default;
+
+    /**
+     * @brief Message whose fields, groups and entries are allocated from resource
+     **/
+    explicit FixMessage(std::pmr::memory_resource* resource): fields_(resource), groups_(resource), slots_(resource) {}
+
+    auto getValue(const FieldRef& field) const noexcept -> std::string_view {
+        return rawMsg_.substr( field.offset_, field.length_ );
+    }
+
+    /**
+     * @brief Find the first field with the given tag number
+     * @return the field or nullptr if the message doesn't have it
+     **/
+    auto find(TagNumber number) const noexcept -> const FieldRef* {
+
+        for(const auto& field: fields_ ){
+            if( field.number_ == number ){
+                return &field;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @brief Value of the first field with the given tag number
+     * @return the value or an empty view if the message doesn't have the field
+     **/
+    auto getValue(TagNumber number) const noexcept -> std::string_view {
+
+        if( auto field = find( number ) ){
+            return getValue( *field );
+        }
+
+        return {};
+    }
+
+    auto getFieldDef(const FieldRef& field) const noexcept -> const FieldDef* {
+        return dictionary_ ? dictionary_->field( field.number_ ) : nullptr;
+    }
+
+    /**
+     * @brief Typed values of a field, converted when asked for.
+     * The type of the field in the dictionary must match the getter: getInt() for INT, LENGTH, SEQNUM... fields,
+     * getDecimal() for PRICE, QTY, AMT... fields (INT ones too), getTimestamp() for UTCTIMESTAMP fields and
+     * getChar() for CHAR and BOOLEAN fields
+     * @return the value or std::nullopt if the field is absent, of another type or malformed
+     **/
+    auto getInt(const FieldRef& field) const noexcept -> std::optional<std::int64_t> {
+
+        std::int64_t value{};
+
+        if( !isKind( field, FieldKind::INT ) || !parseInt( getValue( field ), value ) ){
+            return std::nullopt;
+        }
+
+        return value;
+    }
+
+    auto getDecimal(const FieldRef& field) const noexcept -> std::optional<Decimal> {
+
+        Decimal value{};
+
+        if( !( isKind( field, FieldKind::DECIMAL ) || isKind( field, FieldKind::INT ) ) || !parseDecimal( getValue( field ), value ) ){
+            return std::nullopt;
+        }
+
+        return value;
+    }
+
+    /**
+     * @return the number of nanoseconds since the epoch or std::nullopt
+     **/
+    auto getTimestamp(const FieldRef& field) const noexcept -> std::optional<std::int64_t> {
+
+        std::int64_t value{};
+
+        if( !isKind( field, FieldKind::TIMESTAMP ) || !parseTimestamp( getValue( field ), value ) ){
+            return std::nullopt;
+        }
+
+        return value;
+    }
+
+    auto getChar(const FieldRef& field) const noexcept -> std::optional<char> {
+
+        auto value = getValue( field );
+
+        if( !isKind( field, FieldKind::CHAR ) || value.size() != 1 ){
+            return std::nullopt;
+        }
+
+        return value.front();
+    }
+
+    auto getInt(TagNumber number) const noexcept -> std::optional<std::int64_t> {
+        auto field = find( number );
+        return field ? getInt( *field ) : std::nullopt;
+    }
+
+    auto getDecimal(TagNumber number) const noexcept -> std::optional<Decimal> {
+        auto field = find( number );
+        return field ? getDecimal( *field ) : std::nullopt;
+    }
+
+    auto getTimestamp(TagNumber number) const noexcept -> std::optional<std::int64_t> {
+        auto field = find( number );
+        return field ? getTimestamp( *field ) : std::nullopt;
+    }
+
+    auto getChar(TagNumber number) const noexcept -> std::optional<char> {
+        auto field = find( number );
+        return field ? getChar( *field ) : std::nullopt;
+    }
+
+    auto isKind(const FieldRef& field, FieldKind kind) const noexcept -> bool {
+        auto fieldInfo = getInfo( field );
+        return fieldInfo.isDefined_ && fieldInfo.kind_ == kind;
+    }
+
+    auto getPlacement(const FieldRef& field) const noexcept -> Placement {
+        return getInfo( field ).placement_;
+    }
+
+    /**
+     * @return the packed description of the field, with isDefined_ false when the message has no dictionary
+     **/
+    auto getInfo(const FieldRef& field) const noexcept -> FieldInfo {
+        return dictionary_ ? dictionary_->info( field.number_ ) : FieldInfo{};
+    }
+
+    /**
+     * @brief Enum entry matching the value of the field
+     * @return the enum entry or nullptr if the field has no such value
+     **/
+    auto getEnum(const FieldRef& field) const noexcept -> const Value* {
+        return dictionary_ ? dictionary_->enumValue( field.number_, getValue( field ) ) : nullptr;
+    }
+
+    /**
+     * @brief Point to a new raw message, keeping the memory of the fields
+     **/
+    auto reset(std::string_view rawMsg, const Dictionary* dictionary) noexcept -> void {
+        rawMsg_ = rawMsg;
+        dictionary_ = dictionary;
+        fields_.clear();
+        groups_.clear();
+        slots_.clear();
+    }
+
+    /**
+     * @brief Find a group at the top level of the message from its NumInGroup field
+     * @return the group or nullptr if the message doesn't have it
+     **/
+    auto group(TagNumber countTag) const noexcept -> const GroupRef* {
+
+        for(const auto& group: groups_ ){
+            if( group.parent_ == GroupRef::noParent && group.groupDef_->countTag_ == countTag ){
+                return &group;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @brief Find a group nested in an entry of another group from its NumInGroup field
+     * @return the group or nullptr if the entry doesn't have it
+     **/
+    auto group(const GroupRef& parent, std::uint32_t entry, TagNumber countTag) const noexcept -> const GroupRef* {
+
+        auto parentIndex = static_cast<std::uint32_t>( &parent - groups_.data() );
+
+        for(auto i = parentIndex + 1; i < groups_.size(); ++i ){
+
+            const auto& group = groups_[i];
+
+            if( group.parent_ == parentIndex && group.parentEntry_ == entry && group.groupDef_->countTag_ == countTag ){
+                return &group;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @brief Find the field with the given tag number in an entry of a group, in constant time once
+     * the member is located in the group definition
+     * @return the field or nullptr if the entry doesn't have it
+     **/
+    auto find(const GroupRef& group, std::uint32_t entry, TagNumber number) const noexcept -> const FieldRef* {
+
+        auto slot = group.groupDef_->slot( number );
+
+        if( slot < 0 || entry >= group.entryCount_ ){
+            return nullptr;
+        }
+
+        auto index = slots_[ group.firstSlot_ + entry * group.groupDef_->members_.size() + slot ];
+
+        return index == noField ? nullptr : &fields_[index];
+    }
+
+    /**
+     * @brief Value of the field with the given tag number in an entry of a group
+     * @return the value or an empty view if the entry doesn't have the field
+     **/
+    auto getValue(const GroupRef& group, std::uint32_t entry, TagNumber number) const noexcept -> std::string_view {
+
+        if( auto field = find( group, entry, number ) ){
+            return getValue( *field );
+        }
+
+        return {};
+    }
+};
+
+/**
+ * @brief How much of a message is checked, each level doing what the previous one does and more
+ **/
+enum class ValidationLevel : char {
+    NONE,       // The message is only split in fields
+    FRAMING,    // BodyLength is the second field and matches the body, CheckSum is the last field
+    CHECKSUM,   // The CheckSum value matches the message
+    STRUCTURE,  // Every field is known, the required fields are present, the groups have their declared entries
+    FULL        // The values match the type of their field and its enum values
+};
+
+/**
+ * @brief The validation level of the messages, with a different level for some MsgTypes
+ **/
+struct ValidationProfile{
+    ValidationLevel level_{ValidationLevel::STRUCTURE};
+    std::vector<std::pair<std::string, ValidationLevel>> overrides_; // (MsgType, level), a few entries at most
+
+    auto levelOf(std::string_view msgType) const noexcept -> ValidationLevel {
+
+        for(const auto& [type, level]: overrides_ ){
+            if( type == msgType ){
+                return level;
+            }
+        }
+
+        return level_;
+    }
+
+    /**
+     * @return false if no message is checked up to its structure, the messages can then be checked without dictionary
+     **/
+    auto needsDictionary() const noexcept -> bool {
+        return level_ >= ValidationLevel::STRUCTURE ||
+               std::any_of( overrides_.begin(), overrides_.end(), [](const auto& entry){ return entry.second >= ValidationLevel::STRUCTURE; } );
+    }
+};
+
+class DictionaryRegistry;
+
+struct Config{
+
+    Config(): pathSrc_("/usr/local/etc"), fixStd_(FixStd::FIX44), SOH_('|'){}
+
+    template<typename Path, typename=std::enable_if_t<std::is_constructible_v<std::string, Path> > >
+    Config(Path&& pathSrc,const char soh='|'): pathSrc_(std::forward<Path>(pathSrc)), SOH_(soh) {}
+
+    template<typename Path, typename=std::enable_if_t<std::is_constructible_v<std::string, Path> > >
+    Config(Path&& pathSrc, FixStd&& fixStd, const char soh='|'): pathSrc_(std::forward<Path>(pathSrc)),
+                                          fixStd_(std::move(fixStd)), SOH_(soh) {}
+
+    /**
+     * @brief Config using an already built dictionary, e.g fix44::dictionary() from the generated tables.
+     * Nothing is loaded from the disk
+     **/
+    explicit Config(std::shared_ptr<const Dictionary> dictionary, const char soh='|'): SOH_(soh), dictionary_(std::move(dictionary)) {}
+
+    /**
+     * @brief Config checking each message with the dictionary of its version, see DictionaryRegistry
+     **/
+    explicit Config(std::shared_ptr<const DictionaryRegistry> registry, const char soh='|'): SOH_(soh), registry_(std::move(registry)) {}
+
+    auto getPath() const{
+        return pathSrc_;
+    }
+
+    auto getFixStd() const{
+        return fixStd_;
+    }
+
+    auto getSOH() const{
+        return SOH_;
+    }
+
+    /**
+     * @brief Set the validation level of every message, STRUCTURE by default
+     **/
+    auto setValidation(ValidationLevel level) -> Config& {
+        validation_.level_ = level;
+        return *this;
+    }
+
+    /**
+     * @brief Set the validation level of the messages of type msgType, whatever the level of the others
+     **/
+    auto setValidation(std::string_view msgType, ValidationLevel level) -> Config& {
+
+        for(auto& [type, typeLevel]: validation_.overrides_ ){
+            if( type == msgType ){
+                typeLevel = level;
+                return *this;
+            }
+        }
+
+        validation_.overrides_.emplace_back( std::string(msgType), level );
+        return *this;
+    }
+
+    auto getValidation() const noexcept -> const ValidationProfile& {
+        return validation_;
+    }
+
+    /**
+     * @brief Decode the messages of type msgType with a decoder specialized for it, see MessageDecoder.
+     * Meant for the few MsgTypes making most of the traffic, the others go through the generic stages
+     **/
+    auto addHotMsgType(std::string_view msgType) -> Config& {
+
+        if( std::find( hotMsgTypes_.begin(), hotMsgTypes_.end(), msgType ) == hotMsgTypes_.end() ){
+            hotMsgTypes_.emplace_back( msgType );
+        }
+
+        return *this;
+    }
+
+    auto getHotMsgTypes() const noexcept -> const std::vector<std::string>& {
+        return hotMsgTypes_;
+    }
+
+    /**
+     * @brief Merge the specification file at path on top of the one of the FIX version, e.g for the custom fields of a venue.
+     * The extensions are merged in the order they're added
+     **/
+    template<typename Path, typename=std::enable_if_t<std::is_constructible_v<std::string, Path> > >
+    auto addExtension(Path&& path) -> Config& {
+        extensions_.emplace_back( std::forward<Path>(path) );
+        return *this;
+    }
+
+    auto getExtensions() const noexcept -> const std::vector<std::string>& {
+        return extensions_;
+    }
+
+    auto getRegistry() const noexcept -> const std::shared_ptr<const DictionaryRegistry>& {
+        return registry_;
+    }
+
+    /**
+     * @brief Dictionary compiled from the specification pointed by this config.
+     * It's loaded the first time it's needed and then reused by every call made with this config
+     **/
+    auto getDictionary() -> const std::shared_ptr<const Dictionary>&;
+
+    /**
+     * @brief The dictionary if it's already loaded or was given, nothing is loaded
+     **/
+    auto getLoadedDictionary() const noexcept -> const std::shared_ptr<const Dictionary>& {
+        return dictionary_;
+    }
+
+    private:
+        std::string pathSrc_;
+        FixStd fixStd_{FixStd::FIX44};
+        char SOH_;
+        std::shared_ptr<const Dictionary> dictionary_;
+        std::shared_ptr<const DictionaryRegistry> registry_;
+        std::vector<std::string> extensions_;
+        std::vector<std::string> hotMsgTypes_;
+        ValidationProfile validation_;
+
+};
+
+inline auto ErrorBag::describe(const Error& error) const -> std::string {
+
+    auto fieldDef = dictionary_ ? dictionary_->field( error.tag_ ) : nullptr;
+    auto name = fieldDef ? fieldDef->name_ : "tag=" + std::to_string( error.tag_ );
+
+    // The text of the field at the offset of the error, from its tag up to the '=' or from the '=' up to the SOH
+    auto rawField = error.offset_ < rawMsg_.size() ? rawMsg_.substr( error.offset_ ) : std::string_view{};
+         rawField = rawField.substr( 0, rawField.find( soh_ ) );
+
+    auto equal = rawField.find( '=' );
+    auto rawTag = rawField.substr( 0, equal );
+    auto rawValue = equal == std::string_view::npos ? std::string_view{} : rawField.substr( equal + 1 );
+
+    auto valueOr = [&rawField, &rawValue](std::int32_t number){
+        return rawField.empty() ? std::to_string( number ) : std::string( rawValue );
+    };
+
+    switch( error.kind_ ){
+
+        case ErrorKind::INVALID_TAG_NUMBER:
+        case ErrorKind::UNDEFINED_TAG:
+            return "Field with tag=" + ( rawField.empty() ? std::to_string( error.tag_ ) : std::string( rawTag ) ) + " not found";
+
+        case ErrorKind::REQUIRED_TAG_MISSING: {
+            // A field can only be in the section the dictionary places it in
+            std::string section = !fieldDef                                 ? "BODY" :
+                                  fieldDef->placement_ == Placement::HEADER  ? "HEADER" :
+                                  fieldDef->placement_ == Placement::TRAILER ? "TRAILER" : "BODY";
+
+            return section + ": the tag with name=" + name + " is required";
+        }
+
+        case ErrorKind::VALUE_OUT_OF_RANGE:
+            return "Value is incorrect (out of range) for the tag with name=" + name + ": " + std::string( rawValue );
+
+        case ErrorKind::INCORRECT_DATA_FORMAT:
+            return "Incorrect data format for the tag with name=" + name;
+
+        case ErrorKind::INVALID_MSGTYPE:
+            return "The message type is invalid";
+
+        case ErrorKind::TAG_OUT_OF_ORDER:
+            return error.tag_ == 9  ? "The BodyLength field should be the second field of the message" :
+                   error.tag_ == 10 ? "The CheckSum field should be the last field of the message" :
+                                      "The tag with name=" + name + " is out of the required order";
+
+        case ErrorKind::INCORRECT_NUMINGROUP_COUNT:
+            // More entries than expected are only counted up to one past the expected count
+            return "Incorrect NumInGroup count for repeating group " + name + ".\nExpected: " + valueOr( error.expected_ ) +
+                   "\nGot: " + ( error.actual_ > error.expected_ ? "more than " + std::to_string( error.actual_ - 1 )
+                                                                 : std::to_string( error.actual_ ) );
+
+        case ErrorKind::BODY_LENGTH_MISMATCH:
+            return "Message body length mismatch.\nExpected: " + std::to_string( error.expected_ ) + "\nGot: " + valueOr( error.actual_ );
+
+        case ErrorKind::CHECKSUM_SIZE:
+            return "The checksum size is invalid. It should be 3";
+
+        case ErrorKind::CHECKSUM_MISMATCH: {
+            // The checksum is always displayed on 3 digits, a checksum of 1 becomes 001 and 12 becomes 012
+            auto expected = std::to_string( error.expected_ );
+                 expected = std::string( 3 - std::min<std::size_t>( expected.size(), 3 ), '0' ) + expected;
+
+            return "The message checksum is invalid.\nExpected: " + expected + "\nGot: " + valueOr( error.actual_ ) + "\n";
+        }
+
+        case ErrorKind::NO_DICTIONARY:
+            return "Cannot open the FIX spec file.";
+
+        case ErrorKind::UNSUPPORTED_VERSION:
+            return "No FIX specification for the version " + std::string( rawValue );
+
+        default:
+            return "Error on the tag with name=" + name;
+    }
+}
+
+inline auto operator<<(std::ostream& os, const ErrorBag& errBag) -> std::ostream&{
+    if( errBag.isEmpty() ){
+        os << "No errors found" << "\n";
+        return os;
+    }
+
+     os << "A total of " << errBag.size_ + errBag.dropped_ << " error(s) found \n\n";
+    for(const auto& err: errBag ){
+        os << errBag.describe( err ) << "\n";
+    }
+
+    if( errBag.dropped_ != 0 ){
+        os << "... and " << errBag.dropped_ << " more\n";
+    }
+
+    return os;
+}
+
+template <typename T,typename S=std::enable_if_t< std::is_convertible_v<T, std::string>, std::string> >
+[[nodiscard]] constexpr auto split(T&& str, const char delimiter) noexcept -> std::vector<S> {
+
+  auto strToConvert = std::string(std::forward<T>(str));
+  std::vector<S> internal;
+
+  std::stringstream ss( std::forward<S>(strToConvert)); // Turn the string into a stream.
+  std::string tok;
+
+  while (getline(ss, tok, delimiter)) {
+    internal.emplace_back(tok);
+  }
+
+  return internal;
+}
+
+/**
+ * @brief Convert the textual tag of a field into its number
+ * @return the tag number or 0 if str is not a valid tag
+ **/
+[[nodiscard]] constexpr auto toTagNumber(std::string_view str) noexcept -> TagNumber {
+
+    // Tags are written without leading zeros
+    if( str.empty() || str.size() > 9 || str.front() == '0' ){
+        return 0;
+    }
+
+    TagNumber number{};
+
+    for(auto c: str ){
+        if( c < '0' || c > '9' ){
+            return 0;
+        }
+        number = number * 10 + static_cast<TagNumber>( c - '0' );
+    }
+
+    return number;
+}
+
+/**
+ * @brief Split a raw message into its fields in a single pass, without copying anything.
+ * The tag numbers are converted as they're found, the values are views over message so it must outlive fields.
+ * fields is cleared first, its capacity is kept so a caller reusing it doesn't allocate once it has grown
+ * @return the number of fields found
+ **/
+inline auto tokenize(std::string_view message, const char soh, FieldArray& fields) noexcept -> std::size_t {
+
+    fields.clear();
+
+    std::size_t pos{};
+
+    while( pos < message.size() ){
+
+        FieldView field;
+        field.offset_ = static_cast<std::uint32_t>( pos );
+
+        while( pos < message.size() && message[pos] != '=' && message[pos] != soh ){
+            ++pos;
+        }
+
+        if( pos < message.size() && message[pos] == '=' ){
+
+            field.number_ = toTagNumber( message.substr( field.offset_, pos - field.offset_ ) );
+
+            auto valueBegin = ++pos;
+
+            while( pos < message.size() && message[pos] != soh ){
+                ++pos;
+            }
+
+            field.value_ = message.substr( valueBegin, pos - valueBegin );
+        }
+        // else a field without '=' is malformed, its number stays 0
+
+        fields.emplace_back( field );
+
+        ++pos; // Skipping the SOH
+    }
+
+    return fields.size();
+}
+
+namespace simd {
+
+/**
+ * @brief Byte at a time delimiter scan, used when no vector unit is available and for the tail of the vectorized scans
+ **/
+inline auto scanScalar(std::string_view message, const char soh, DelimiterIndex& index, std::size_t from = 0, std::uint32_t byteSum = 0) noexcept -> void {
+
+    for(auto i = from; i < message.size(); ++i ){
+
+        auto c = message[i];
+
+        if( c == soh ){
+            index.positions_.emplace_back( static_cast<std::uint32_t>(i) );
+            byteSum += 1;
+        }else{
+            if( c == '=' ){
+                index.positions_.emplace_back( static_cast<std::uint32_t>(i) );
+            }
+            byteSum += static_cast<unsigned char>( c );
+        }
+    }
+
+    index.byteSum_ = byteSum;
+}
+
+#ifdef FIXPARSER_X86_SIMD
+
+// Append the positions of the bits set in mask, offset by base
+inline auto appendPositions(std::uint32_t mask, std::size_t base, DelimiterIndex& index) -> void {
+
+    while( mask ){
+        index.positions_.emplace_back( static_cast<std::uint32_t>( base + __builtin_ctz(mask) ) );
+        mask &= mask - 1;
+    }
+}
+
+inline auto scanSse2(std::string_view message, const char soh, DelimiterIndex& index) noexcept -> void {
+
+    const auto* data = message.data();
+    const auto sohs = _mm_set1_epi8( soh );
+    const auto equals = _mm_set1_epi8( '=' );
+    const auto zero = _mm_setzero_si128();
+
+    auto sums = _mm_setzero_si128();
+    std::uint32_t sohCount{};
+    std::size_t i{};
+
+    for(; i + 16 <= message.size(); i += 16 ){
+
+        auto chunk = _mm_loadu_si128( reinterpret_cast<const __m128i*>( data + i ) );
+
+        auto sohMask = static_cast<std::uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( chunk, sohs ) ) );
+        auto equalMask = static_cast<std::uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( chunk, equals ) ) );
+
+        sums = _mm_add_epi64( sums, _mm_sad_epu8( chunk, zero ) );
+        sohCount += static_cast<std::uint32_t>( __builtin_popcount( sohMask ) );
+
+        appendPositions( sohMask | equalMask, i, index );
+    }
+
+    auto byteSum = static_cast<std::uint32_t>( _mm_cvtsi128_si32( sums ) + _mm_cvtsi128_si32( _mm_unpackhi_epi64( sums, sums ) ) );
+
+    // Each SOH counts as 1 in the checksum
+    byteSum -= sohCount * ( static_cast<unsigned char>( soh ) - 1u );
+
+    scanScalar( message, soh, index, i, byteSum );
+}
+
+__attribute__((target("avx2")))
+inline auto scanAvx2(std::string_view message, const char soh, DelimiterIndex& index) noexcept -> void {
+
+    const auto* data = message.data();
+    const auto sohs = _mm256_set1_epi8( soh );
+    const auto equals = _mm256_set1_epi8( '=' );
+    const auto zero = _mm256_setzero_si256();
+
+    auto sums = _mm256_setzero_si256();
+    std::uint32_t sohCount{};
+    std::size_t i{};
+
+    for(; i + 32 <= message.size(); i += 32 ){
+
+        auto chunk = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( data + i ) );
+
+        auto sohMask = static_cast<std::uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( chunk, sohs ) ) );
+        auto equalMask = static_cast<std::uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( chunk, equals ) ) );
+
+        sums = _mm256_add_epi64( sums, _mm256_sad_epu8( chunk, zero ) );
+        sohCount += static_cast<std::uint32_t>( __builtin_popcount( sohMask ) );
+
+        appendPositions( sohMask | equalMask, i, index );
+    }
+
+    auto low = _mm256_castsi256_si128( sums );
+    auto high = _mm256_extracti128_si256( sums, 1 );
+    auto both = _mm_add_epi64( low, high );
+
+    auto byteSum = static_cast<std::uint32_t>( _mm_cvtsi128_si32( both ) + _mm_cvtsi128_si32( _mm_unpackhi_epi64( both, both ) ) );
+
+    byteSum -= sohCount * ( static_cast<unsigned char>( soh ) - 1u );
+
+    scanScalar( message, soh, index, i, byteSum );
+}
+
+#endif
+
+enum class ScanMode : char {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+/**
+ * @brief The best scan the running CPU supports, detected once
+ **/
+inline auto bestScanMode() noexcept -> ScanMode {
+
+#ifdef FIXPARSER_X86_SIMD
+    static const auto mode = __builtin_cpu_supports("avx2") ? ScanMode::AVX2 : ScanMode::SSE2;
+    return mode;
+#else
+    return ScanMode::SCALAR;
+#endif
+}
+
+inline auto scan(std::string_view message, const char soh, DelimiterIndex& index, ScanMode mode) noexcept -> void {
+
+    index.positions_.clear();
+    index.positions_.reserve( message.size() / 2 );
+
+    switch( mode ){
+#ifdef FIXPARSER_X86_SIMD
+        case ScanMode::AVX2:
+            scanAvx2( message, soh, index );
+            break;
+        case ScanMode::SSE2:
+            scanSse2( message, soh, index );
+            break;
+#endif
+        default:
+            scanScalar( message, soh, index );
+            break;
+    }
+}
+
+} // namespace simd
+
+/**
+ * @brief Find every SOH and '=' of a message in one sweep, computing the checksum byte sum on the way.
+ * The widest vector unit available at runtime is used. index is reused, it only allocates when growing
+ **/
+inline auto scanDelimiters(std::string_view message, const char soh, DelimiterIndex& index) noexcept -> void {
+    simd::scan( message, soh, index, simd::bestScanMode() );
+}
+
+/**
+ * @brief Split a raw message into its fields using the delimiters found by scanDelimiters()
+ * The values are views over message so it must outlive fields
+ * @return the number of fields found
+ **/
+inline auto tokenize(std::string_view message, const char soh, const DelimiterIndex& index, FieldArray& fields) noexcept -> std::size_t {
+
+    fields.clear();
+
+    const auto& positions = index.positions_;
+    std::size_t next{};
+    std::size_t fieldBegin{};
+
+    while( fieldBegin < message.size() ){
+
+        FieldView field;
+        field.offset_ = static_cast<std::uint32_t>( fieldBegin );
+
+        if( next < positions.size() && message[ positions[next] ] == '=' ){
+
+            std::size_t equal = positions[next++];
+
+            // Any other '=' before the SOH belongs to the value
+            while( next < positions.size() && message[ positions[next] ] != soh ){
+                ++next;
+            }
+
+            std::size_t fieldEnd = next < positions.size() ? positions[next++] : message.size();
+
+            field.number_ = toTagNumber( message.substr( fieldBegin, equal - fieldBegin ) );
+            field.value_ = message.substr( equal + 1, fieldEnd - equal - 1 );
+            fieldBegin = fieldEnd + 1;
+
+        }else{
+            // A field without '=' is malformed
+            fieldBegin = ( next < positions.size() ? positions[next++] : message.size() ) + 1;
+        }
+
+        fields.emplace_back( field );
+    }
+
+    return fields.size();
+}
+
+/**
+ * @brief Layouts of the human readable rendering of a message.
+ * PRETTY is one field per paragraph grouped by header, body and trailer, ONE_LINE puts the fields on a single
+ * line in the order of the message and JSON gives an object with the array of the fields
+ **/
+enum class HumanFormat{
+    PRETTY,
+    ONE_LINE,
+    JSON
+};
+
+/**
+ * @brief Where a message is rendered: a buffer of the caller, cut once it's full, or a std::string the text is
+ * appended to. The size counts the whole text, including what didn't fit in the buffer.
+ * The string is written through its buffer and only holds the text, without any padding, once the sink is gone
+ **/
+class TextSink{
+
+    public:
+
+        TextSink(char* buffer, std::size_t capacity) noexcept : buffer_( buffer ), capacity_( capacity ){}
+
+        explicit TextSink(std::string& text) noexcept : text_( &text ), start_( text.size() ){}
+
+        TextSink(const TextSink&) = delete;
+        TextSink& operator=(const TextSink&) = delete;
+
+        ~TextSink(){
+            if( text_ ){
+                text_->resize( start_ + size_ );
+            }
+        }
+
+        auto append(std::string_view text) -> void {
+
+            if( size_ + text.size() > capacity_ && text_ ){
+                grow( size_ + text.size() );
+            }
+
+            if( size_ < capacity_ ){
+                std::memcpy( buffer_ + size_, text.data(), std::min( text.size(), capacity_ - size_ ) );
+            }
+
+            size_ += text.size();
+        }
+
+        auto append(char c) -> void {
+            append( std::string_view( &c, 1 ) );
+        }
+
+        auto appendNumber(std::uint64_t value) -> void {
+
+            char digits[20];
+            auto begin = std::end( digits );
+
+            do{
+                *--begin = static_cast<char>( '0' + value % 10 );
+                value /= 10;
+            }while( value != 0 );
+
+            append( std::string_view( begin, static_cast<std::size_t>( std::end( digits ) - begin ) ) );
+        }
+
+        /**
+         * @brief Append text as the content of a JSON string
+         **/
+        auto appendEscaped(std::string_view text) -> void {
+
+            constexpr char hex[] = "0123456789abcdef";
+            std::size_t plain{0};
+
+            for(std::size_t i{0}; i != text.size(); ++i ){
+
+                auto c = static_cast<unsigned char>( text[i] );
+
+                if( c >= 0x20 && c != '"' && c != '\\' ){
+                    continue;
+                }
+
+                append( text.substr( plain, i - plain ) );
+                plain = i + 1;
+
+                if( c == '"' || c == '\\' ){
+                    append( '\\' );
+                    append( static_cast<char>( c ) );
+                }else if( c == '\n' ){
+                    append( "\\n" );
+                }else if( c == '\t' ){
+                    append( "\\t" );
+                }else{
+                    char escaped[] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+                    append( std::string_view( escaped, sizeof(escaped) ) );
+                }
+            }
+
+            append( text.substr( plain ) );
+        }
+
+        /**
+         * @return the length of the whole text, it didn't fit in the buffer if it's above its capacity
+         **/
+        auto size() const noexcept -> std::size_t {
+            return size_;
+        }
+
+    private:
+
+        // Doubling the string keeps the zeroing done by resize() linear in the length of the text.
+        // The growth stops at the capacity reserved by the caller, the string only reallocates once the text outgrows it
+        auto grow(std::size_t needed) -> void {
+
+            auto size = std::max( { needed, 2 * capacity_, std::size_t{256} } );
+            auto reserved = text_->capacity() - start_;
+
+            if( needed <= reserved ){
+                size = std::min( size, reserved );
+            }
+
+            text_->resize( start_ + size );
+            buffer_ = text_->data() + start_;
+            capacity_ = text_->size() - start_;
+        }
+
+        char* buffer_{};
+        std::size_t capacity_{};
+        std::string* text_{};
+        std::size_t start_{};
+        std::size_t size_{};
+};
+
+/**
+ * @brief Render a field in the given format.
+ * The names and enum descriptions are the ones of the dictionary of the message, a field it doesn't define
+ * is rendered with its tag number only
+ **/
+inline auto renderField(const FixMessage& fixMsg, const FieldRef& field, HumanFormat format, TextSink& out) -> void {
+
+    auto fieldDef = fixMsg.getFieldDef( field );
+    auto value = fixMsg.getValue( field );
+    auto foundEnum = fieldDef && !fieldDef->values_.empty() ? fixMsg.getEnum( field ) : nullptr;
+    auto isBadEnum = fieldDef && !fieldDef->values_.empty() && !foundEnum;
+
+    switch( format ){
+
+        case HumanFormat::PRETTY:
+
+            out.appendNumber( field.number_ );
+            out.append( "\t\t" );
+
+            if( !fieldDef ){
+                out.append( value );
+            }else if( isBadEnum ){
+                out.append( value );
+                out.append( " is not a correct value for tag " );
+                out.append( fieldDef->name_ );
+            }else{
+                out.append( fieldDef->name_ );
+                out.append( ": " );
+
+                if( foundEnum ){
+                    out.append( foundEnum->description_ );
+                    out.append( " (" );
+                    out.append( value );
+                    out.append( ')' );
+                }else{
+                    out.append( value );
+                }
+            }
+
+            out.append( "\n\n" );
+            break;
+
+        case HumanFormat::ONE_LINE:
+
+            if( fieldDef ){
+                out.append( fieldDef->name_ );
+                out.append( '(' );
+                out.appendNumber( field.number_ );
+                out.append( ")=" );
+            }else{
+                out.appendNumber( field.number_ );
+                out.append( '=' );
+            }
+
+            out.append( value );
+
+            if( foundEnum ){
+                out.append( " (" );
+                out.append( foundEnum->description_ );
+                out.append( ')' );
+            }
+
+            break;
+
+        case HumanFormat::JSON:
+
+            out.append( "{\"tag\":" );
+            out.appendNumber( field.number_ );
+
+            if( fieldDef ){
+                out.append( ",\"name\":\"" );
+                out.appendEscaped( fieldDef->name_ );
+                out.append( '"' );
+            }
+
+            out.append( ",\"value\":\"" );
+            out.appendEscaped( value );
+            out.append( '"' );
+
+            if( foundEnum ){
+                out.append( ",\"description\":\"" );
+                out.appendEscaped( foundEnum->description_ );
+                out.append( '"' );
+            }
+
+            out.append( '}' );
+            break;
+    }
+}
+
+/**
+ * @brief Render a FixMessage in a human readable way, without any stream
+ **/
+inline auto toHuman(const FixMessage& fixMsg, TextSink& out, HumanFormat format = HumanFormat::PRETTY) -> void {
+
+    if( format == HumanFormat::PRETTY ){
+
+        auto renderSection = [&](const char* title, Placement placement){
+
+            out.append( title );
+            out.append( "\n\n" );
+
+            for(const auto& field: fixMsg.fields_ ){
+
+                auto fieldDef = fixMsg.getFieldDef( field );
+
+                if( ( fieldDef ? fieldDef->placement_ : Placement::BODY ) == placement ){
+                    renderField( fixMsg, field, format, out );
+                }
+            }
+        };
+
+        renderSection( "HEADER", Placement::HEADER );
+        renderSection( "BODY", Placement::BODY );
+        renderSection( "TRAILER", Placement::TRAILER );
+        return;
+    }
+
+    if( format == HumanFormat::JSON ){
+        out.append( "{\"fields\":[" );
+    }
+
+    for(std::size_t i{0}; i != fixMsg.fields_.size(); ++i ){
+
+        if( i != 0 ){
+            out.append( format == HumanFormat::JSON ? "," : " | " );
+        }
+
+        renderField( fixMsg, fixMsg.fields_[i], format, out );
+    }
+
+    if( format == HumanFormat::JSON ){
+        out.append( "]}" );
+    }
+}
+
+/**
+ * @brief Append the rendering of fixMsg to text, reserve its capacity beforehand to render without allocating
+ **/
+inline auto toHuman(const FixMessage& fixMsg, std::string& text, HumanFormat format = HumanFormat::PRETTY) -> void {
+    TextSink out( text );
+    toHuman( fixMsg, out, format );
+}
+
+/**
+ * @brief Render fixMsg in buffer, the text isn't null terminated and is cut if it doesn't fit
+ * @return the length of the whole text, above size when it was cut
+ **/
+inline auto toHuman(const FixMessage& fixMsg, char* buffer, std::size_t size, HumanFormat format = HumanFormat::PRETTY) -> std::size_t {
+    TextSink out( buffer, size );
+    toHuman( fixMsg, out, format );
+    return out.size();
+}
+
+inline auto printField(const FixMessage& fixMsg, const FieldRef& field) -> void {
+
+    std::string text;
+
+    {
+        // The sink trims text to what was rendered only once destroyed
+        TextSink out( text );
+        renderField( fixMsg, field, HumanFormat::PRETTY, out );
+    }
+
+    std::cout << text;
+}
+
+/**
+ * @brief Pretty print a FixMessage
+ **/
+template<typename T>
+constexpr auto prettyPrint(T&& fixMsg) -> void {
+
+    static_assert( std::is_same_v<std::remove_cv_t<std::remove_reference_t<T>>, FixMessage>);
+
+    // Rendered first so that the stream is written to once
+    std::string text;
+    text.reserve( 64 * fixMsg.fields_.size() + 32 );
+
+    toHuman( fixMsg, text );
+    std::cout << text;
+}
+
+
+/**
+ * @brief map a given FIX version to supported one and give the path of the corresponding dictionnary
+ * @return the path of the XML specification for the config
+ **/
+
+[[nodiscard]] inline auto mapVersionToFile(const Config& config) -> fs::path {
+
+    auto mappedVersion = [&config](){
+        switch (config.getFixStd()){
+            case FixStd::FIX42:
+                return "FIX42";
+                break;
+            case FixStd::FIX43:
+                return "FIX43";
+                break;
+            case FixStd::FIX50SP2:
+                return "FIX50SP2";
+                break;
+            default:
+                return "FIX44";
+                break;
+        }
+    }();
+
+    std::string fileName = mappedVersion;
+                fileName += ".xml";
+
+    return fs::path( config.getPath() ) / "fixparser" / fileName;
+}
+
+/**
+ * @brief The specification files making the dictionary of the config, the extensions coming last
+ **/
+[[nodiscard]] inline auto specFiles(const Config& config) -> std::vector<fs::path> {
+
+    std::vector<fs::path> files;
+
+    // FIX 5.0 leaves the session layer, header and trailer included, to the FIXT 1.1 specification
+    if( config.getFixStd() == FixStd::FIX50SP2 ){
+        files.emplace_back( fs::path( config.getPath() ) / "fixparser" / "FIXT11.xml" );
+    }
+
+    files.emplace_back( mapVersionToFile( config ) );
+
+    for(const auto& extension: config.getExtensions() ){
+        files.emplace_back( extension );
+    }
+
+    return files;
+}
+
+#if __has_include("fixparser_fix44.hpp")
+#define FIXPARSER_FIX44_TABLES
+
+// Defined by the generated header, which is included at the end of this one
+namespace fix44 {
+inline auto dictionary() -> const std::shared_ptr<const Dictionary>&;
+}
+#endif
+
+/**
+ * @brief Load the dictionary matching the config.
+ * A set of specification files is compiled only once per process, the following calls share the same dictionary.
+ * FIX44 without extensions comes from the generated tables when fixparser_fix44.hpp is on the include path, no file is read
+ * @return the dictionary or nullptr if the specification cannot be opened, always nullptr when
+ * built with FIXPARSER_NO_PUGIXML and without the generated tables
+ **/
+
+[[nodiscard]] inline auto loadDictionary(const Config& config) -> std::shared_ptr<const Dictionary> {
+
+#ifdef FIXPARSER_FIX44_TABLES
+    if( config.getFixStd() == FixStd::FIX44 && config.getExtensions().empty() ){
+        return fix44::dictionary();
+    }
+#endif
+
+#ifdef FIXPARSER_NO_PUGIXML
+    static_cast<void>( config );
+    return nullptr;
+#else
+    static std::mutex loadMutex;
+    static std::unordered_map<std::string, std::shared_ptr<const Dictionary>> loaded;
+
+    auto files = specFiles( config );
+    std::string source;
+
+    for(const auto& file: files ){
+        source += file.string();
+        source += '\n';
+    }
+
+    std::lock_guard<std::mutex> lock( loadMutex );
+
+    auto& dictionary = loaded[source];
+
+    if( !dictionary ){
+        dictionary = Dictionary::fromFiles( files );
+    }
+
+    return dictionary;
+#endif
+}
+
+inline auto Config::getDictionary() -> const std::shared_ptr<const Dictionary>& {
+
+    // With a registry the dictionary is chosen for each message, there's none for the config itself
+    if( !dictionary_ && !registry_ ){
+        dictionary_ = loadDictionary( *this );
+    }
+
+    return dictionary_;
+}
+
+/**
+ * @brief Dictionaries of several FIX versions, each message is checked with the one of its version.
+ * The dictionary of a message is found from its BeginString(8) and, for FIXT.1.1, its ApplVerID(1128).
+ * It's filled once, the dictionaries being loaded only once per process, and then only read so that it
+ * can be shared by every parser
+ **/
+class DictionaryRegistry{
+
+    public:
+
+        /**
+         * @brief Check the messages of beginString, and of applVerID when it's not empty, with dictionary.
+         * For FIXT.1.1 the dictionary added without ApplVerID is the one of the messages without the field,
+         * those using the DefaultApplVerID of the session
+         **/
+        auto add(std::string_view beginString, std::string_view applVerID, std::shared_ptr<const Dictionary> dictionary) -> DictionaryRegistry& {
+
+            for(auto& entry: entries_ ){
+                if( entry.beginString_ == beginString && entry.applVerID_ == applVerID ){
+                    entry.dictionary_ = std::move(dictionary);
+                    return *this;
+                }
+            }
+
+            hasApplVerIDs_ |= !applVerID.empty();
+            entries_.emplace_back( Entry{ std::string(beginString), std::string(applVerID), std::move(dictionary) } );
+
+            return *this;
+        }
+
+        /**
+         * @brief Check the messages of fixStd with dictionary, the first FIX 5.0 version added is the default of FIXT.1.1
+         **/
+        auto add(FixStd fixStd, std::shared_ptr<const Dictionary> dictionary) -> DictionaryRegistry& {
+
+            if( !applVerID( fixStd ).empty() && !find( beginString( fixStd ), {} ) ){
+                add( beginString( fixStd ), {}, dictionary );
+            }
+
+            return add( beginString( fixStd ), applVerID( fixStd ), std::move(dictionary) );
+        }
+
+        /**
+         * @brief Load the specification of the version of config, with its extensions
+         * @return false if the specification cannot be loaded
+         **/
+        auto load(Config& config) -> bool {
+
+            auto dictionary = config.getDictionary();
+
+            if( !dictionary ){
+                return false;
+            }
+
+            add( config.getFixStd(), std::move(dictionary) );
+            return true;
+        }
+
+        /**
+         * @return the dictionary of the version, falling back to the one without ApplVerID, or nullptr if there's none
+         **/
+        auto find(std::string_view beginString, std::string_view applVerID) const noexcept -> const Dictionary* {
+
+            const Dictionary* fallback{};
+
+            for(const auto& entry: entries_ ){
+
+                if( entry.beginString_ != beginString ){
+                    continue;
+                }
+
+                if( entry.applVerID_ == applVerID ){
+                    return entry.dictionary_.get();
+                }
+
+                if( entry.applVerID_.empty() ){
+                    fallback = entry.dictionary_.get();
+                }
+            }
+
+            return fallback;
+        }
+
+        /**
+         * @brief The dictionary of a raw message, read from its first field and its ApplVerID if any
+         * @return the dictionary or nullptr if the version of the message has none
+         **/
+        auto select(std::string_view message, const char soh) const noexcept -> const Dictionary* {
+
+            if( message.substr( 0, 2 ) != "8=" ){
+                return nullptr;
+            }
+
+            auto beginString = message.substr( 2, message.find( soh ) - 2 );
+            std::string_view applVerID;
+
+            // ApplVerID is a header field, only the header is searched so that a data field of the body holding
+            // the pattern isn't taken for it
+            for(auto pos = message.find( soh ); hasApplVerIDs_ && pos != std::string_view::npos; ){
+
+                auto field = message.substr( pos + 1 );
+                     field = field.substr( 0, field.find( soh ) );
+
+                auto equal = field.find( '=' );
+                std::uint32_t number{};
+
+                if( equal == std::string_view::npos || !toUnsigned( field.substr( 0, equal ), number ) || !isHeaderTag( number ) ){
+                    break;
+                }
+
+                if( number == 1128 ){
+                    applVerID = field.substr( equal + 1 );
+                    break;
+                }
+
+                pos = message.find( soh, pos + 1 );
+            }
+
+            return find( beginString, applVerID );
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return entries_.size();
+        }
+
+    private:
+
+        // The fields of the standard header of every FIX version up to FIXT.1.1, whatever the dictionaries registered
+        static auto isHeaderTag(TagNumber number) noexcept -> bool {
+
+            static constexpr TagNumber headerTags[] = { 8, 9, 34, 35, 43, 49, 50, 52, 56, 57, 90, 91, 97, 115, 116, 122, 128, 129,
+                                                        142, 143, 144, 145, 212, 213, 347, 369, 627, 628, 629, 630, 1128, 1129, 1156 };
+
+            return std::binary_search( std::begin( headerTags ), std::end( headerTags ), number );
+        }
+
+        struct Entry{
+            std::string beginString_;
+            std::string applVerID_;
+            std::shared_ptr<const Dictionary> dictionary_;
+        };
+
+        std::vector<Entry> entries_;
+        bool hasApplVerIDs_{};
+};
+
+/**
+ * @brief take the tokenized fields of a message and categorize each element according to the fix spec
+ * The fields are appended to fixMsg, the errors found are added to errors
+ * @return true if every field is known by the dictionary, false otherwise
+ **/
+
+[[nodiscard]] inline auto categorize(std::string_view message, const FieldArray& fields, const Dictionary& dictionary,
+                                     FixMessage& fixMsg, ErrorBag& errors) noexcept -> bool {
+
+    bool allFieldsFound{true};
+
+    for(const auto& field : fields){
+
+        if( dictionary.info( field.number_ ).isDefined_ ){
+
+            auto offset = static_cast<std::uint32_t>( field.value_.data() - message.data() );
+
+            fixMsg.fields_.emplace_back( FieldRef{ field.number_, static_cast<std::uint32_t>( field.value_.size() ), offset } );
+
+        }else{
+
+            // The field is not a correct field, means the dictionary has no field with number=x
+            // This results in parsing error
+            errors.add( field.number_ == 0 ? ErrorKind::INVALID_TAG_NUMBER : ErrorKind::UNDEFINED_TAG, field.number_, field.offset_ );
+            allFieldsFound = false;
+        }
+
+    }
+
+    return allFieldsFound;
+}
+
+/**
+ * @brief Append every tokenized field to fixMsg, without looking them up in any dictionary.
+ * Used instead of categorize() when the structure of the message isn't checked
+ **/
+inline auto collectFields(std::string_view message, const FieldArray& fields, FixMessage& fixMsg) -> void {
+
+    for(const auto& field : fields){
+
+        auto offset = static_cast<std::uint32_t>( field.value_.data() - message.data() );
+
+        fixMsg.fields_.emplace_back( FieldRef{ field.number_, static_cast<std::uint32_t>( field.value_.size() ), offset } );
+    }
+}
+
+/**
+ * @brief Check for required fields in the message.
+ * The tags of the message are gathered in seen, which is then matched at once against the required set of
+ * its MsgType. An error is only added for the missing fields
+ * @param seen scratch set reused from one message to the next
+ * @return true if the message has required fields, false otherwise
+*/
+template <typename T,typename=std::enable_if_t<std::is_same_v<std::decay_t<T>, FixMessage> > >
+auto hasRequiredFields(T&& message, const Dictionary& dictionary, TagSet& seen, ErrorBag& errors) -> bool{
+
+    seen.clear();
+
+    for(const auto& field: message.fields_ ){
+        seen.insert( field.number_ );
+    }
+
+    // NOTE: There are some conditional required fields, not dealing with them as of now
+    // NOTE: Required components and groups are already flattened in the message definition
+    auto msgDef = dictionary.message( message.getValue( 35 ) );
+
+    // Without a known message type only the header and the trailer can be checked
+    const auto& required = msgDef ? msgDef->allRequired_ : dictionary.sessionRequired();
+
+    if( msgDef && seen.containsAll( required ) ){
+        return true;
+    }
+
+    if( !msgDef ){
+        auto msgType = message.find( 35 );
+        errors.add( ErrorKind::INVALID_MSGTYPE, 35, msgType ? tagBegin( *msgType ) : 0 );
+    }
+
+    seen.forEachMissing( required, [&errors](TagNumber number){
+        errors.add( ErrorKind::REQUIRED_TAG_MISSING, number );
+    });
+
+    return false;
+}
+
+/**
+ * @brief Check for required fields in the message
+ * @return true if the message has required fields, false otherwise
+*/
+template <typename T,typename=std::enable_if_t<std::is_same_v<std::decay_t<T>, FixMessage> > >
+auto hasRequiredFields(T&& message, const Dictionary& dictionary, ErrorBag& errors) -> bool{
+
+    TagSet seen( dictionary.maxNumber() );
+    return hasRequiredFields( std::forward<T>(message), dictionary, seen, errors );
+}
+
+/**
+ * @brief Position of the first byte of the CheckSum field in the raw message
+ * @return the position or 0 if the message doesn't end with the CheckSum field
+ **/
+inline auto checkSumBegin(const FixMessage& message) noexcept -> std::uint32_t {
+
+    if( message.fields_.empty() || message.fields_.back().number_ != 10 ){
+        return 0;
+    }
+
+    return message.fields_.back().offset_ - 3; // 3 = the size of "10="
+}
+
+/**
+ * @brief Check the message body length.
+ * The body starts right after the BodyLength field and ends right before the CheckSum field,
+ * so its length comes from the offsets of the two fields in the raw message
+ * @return true if the body length is correct false otherwise
 */
 template <typename T,typename=std::enable_if_t<std::is_same_v<std::decay_t<T>, FixMessage> > >
-constexpr auto checkBodyLength(T&& message) noexcept -> bool {
+constexpr auto checkBodyLength(T&& message, ErrorBag& errors) noexcept -> bool {
+
+    // The BodyLength field is always the second one, right after BeginString
+    if( message.fields_.size() < 2 || message.fields_[1].number_ != 9 ){
+        errors.add( ErrorKind::TAG_OUT_OF_ORDER, 9 );
+        return false;
+    }
+
+    auto checkSumOffset = checkSumBegin( message );
+
+    if( checkSumOffset == 0 ){
+        errors.add( ErrorKind::TAG_OUT_OF_ORDER, 10 );
+        return false;
+    }
+
+    const auto& bodyLengthField = message.fields_[1];
+    auto bodyBegin = bodyLengthField.offset_ + bodyLengthField.length_ + 1u; // 1 = the SOH ending the BodyLength field
+    auto computedLength = checkSumOffset - bodyBegin;
+
+    std::uint32_t bodyLength{};
+
+    if( !toUnsigned( message.getValue( bodyLengthField ), bodyLength ) || bodyLength != computedLength ){
+        errors.add( ErrorKind::BODY_LENGTH_MISMATCH, 9, tagBegin( bodyLengthField ), static_cast<std::int32_t>( computedLength ),
+                    static_cast<std::int32_t>( bodyLength ) );
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Check if the message checksum is correct
+ * @param byteSum the sum of all the bytes of the raw message as computed by scanDelimiters()
+ * @return true if the checksum is correct false otherwise
+ **/
+
+template<typename T,typename=std::enable_if_t<std::is_same_v<std::decay_t<T>, FixMessage> > >
+constexpr auto checkCheckSum(T&& message, const char soh, std::uint32_t byteSum, ErrorBag& errors) noexcept -> bool {
+
+    auto checkSum = message.getValue( 10 );
+    auto checkSumOffset = checkSumBegin( message );
+
+    // In a FIX message the checksum size need to be 3, e.g 001 or 012
+    std::uint32_t expectedCheckSum{};
+
+    if( checkSum.size() != 3 || checkSumOffset == 0 || !toUnsigned( checkSum, expectedCheckSum ) ){
+        errors.add( ErrorKind::CHECKSUM_SIZE, 10, checkSumOffset );
+        return false;
+    }
+
+    // byteSum covers the whole message, the CheckSum field itself isn't part of the sum
+    for(auto i = std::size_t{checkSumOffset}; i != message.rawMsg_.size(); ++i){
+
+        if( soh != message.rawMsg_[i] ){
+            byteSum -= static_cast<unsigned char>( message.rawMsg_[i] );
+        }else{
+            byteSum -= 1;
+        }
+    }
+
+    auto computedCheckSum = byteSum%256;
+
+    if( computedCheckSum != expectedCheckSum ){
+        errors.add( ErrorKind::CHECKSUM_MISMATCH, 10, checkSumOffset, static_cast<std::int32_t>( computedCheckSum ),
+                    static_cast<std::int32_t>( expectedCheckSum ) );
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Check if the message checksum is correct, summing the bytes of the raw message
+ * @return true if the checksum is correct false otherwise
+ **/
+
+template<typename T,typename=std::enable_if_t<std::is_same_v<std::decay_t<T>, FixMessage> > >
+constexpr auto checkCheckSum(T&& message, const char soh, ErrorBag& errors) noexcept -> bool {
+
+    DelimiterIndex index;
+    scanDelimiters( message.rawMsg_, soh, index );
+
+    return checkCheckSum( std::forward<T>(message), soh, index.byteSum_, errors );
+}
+
+/**
+ * @brief Decode the entries of the group whose NumInGroup field is at pos, and the groups nested in them.
+ * An entry starts with the delimiter of the group and goes on as long as the fields are members of the group.
+ * pos is moved past the last field of the group
+ * @return true if the number of entries matches the NumInGroup value, false otherwise
+ **/
+inline auto decodeGroup(FixMessage& message, const MessageDef& msgDef, std::size_t groupIndex, std::uint32_t parent,
+                        std::uint32_t parentEntry, std::size_t& pos, ErrorBag& errors) -> bool {
+
+    const auto& groupDef = msgDef.groups_[groupIndex];
+    const auto& fields = message.fields_;
+
+    auto countField = static_cast<std::uint32_t>( pos++ );
+    auto columns = groupDef.members_.size();
+
+    std::uint32_t declared{};
+    bool isValid = toUnsigned( message.getValue( fields[countField] ), declared );
+
+    // Every entry holds at least its delimiter, there can't be more entries than fields left
+    auto capacity = columns == 0 ? 0 : std::min<std::size_t>( declared, fields.size() - pos );
+
+    auto groupRef = static_cast<std::uint32_t>( message.groups_.size() );
+    auto firstSlot = static_cast<std::uint32_t>( message.slots_.size() );
+
+    message.groups_.emplace_back( GroupRef{ &groupDef, countField, 0, firstSlot, parent, parentEntry } );
+    message.slots_.resize( firstSlot + capacity * columns, FixMessage::noField );
+
+    std::uint32_t entries{};
+
+    while( entries < capacity && pos < fields.size() && fields[pos].number_ == groupDef.delimiter() ){
+
+        auto row = firstSlot + entries * columns;
+        auto entry = entries++;
+
+        while( pos < fields.size() ){
+
+            auto slot = groupDef.slot( fields[pos].number_ );
+
+            // A field which isn't a member ends the group, the delimiter met again starts the next entry
+            if( slot < 0 || message.slots_[row + slot] != FixMessage::noField ){
+                break;
+            }
+
+            message.slots_[row + slot] = static_cast<std::uint32_t>( pos );
+
+            if( groupDef.nested_[slot] >= 0 ){
+                isValid &= decodeGroup( message, msgDef, groupDef.nested_[slot], groupRef, entry, pos, errors );
+            }else{
+                ++pos;
+            }
+        }
+    }
+
+    message.groups_[groupRef].entryCount_ = entries;
+
+    auto hasMoreEntries = columns != 0 && pos < fields.size() && fields[pos].number_ == groupDef.delimiter();
+
+    if( !isValid || entries != declared || hasMoreEntries ){
+
+        // Entries past the declared count aren't decoded, one more than the count is enough to tell
+        auto found = hasMoreEntries ? std::max( entries, declared ) + 1 : entries;
+
+        errors.add( ErrorKind::INCORRECT_NUMINGROUP_COUNT, groupDef.countTag_, tagBegin( fields[countField] ),
+                    static_cast<std::int32_t>( declared ), static_cast<std::int32_t>( found ) );
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Decode the repeating groups of the message as defined by msgDef, the definition of its MsgType.
+ * The entries are indexed in FixMessage::groups_ and FixMessage::slots_, nothing is copied
+ * @return true if every group has as many entries as its NumInGroup field says, false otherwise
+ **/
+inline auto decodeGroups(FixMessage& message, const MessageDef& msgDef, ErrorBag& errors) -> bool {
+
+    if( msgDef.groups_.empty() ){
+        return true;
+    }
+
+    bool isValid{true};
+
+    for(std::size_t pos{0}; pos < message.fields_.size(); ){
+
+        auto number = message.fields_[pos].number_;
+
+        if( !msgDef.groupCounts_.contains( number ) ){
+            ++pos;
+            continue;
+        }
+
+        auto groupDef = std::find_if( msgDef.groups_.begin(), msgDef.groups_.end(), [number](const auto& group){
+                                          return group.parent_ < 0 && group.countTag_ == number;
+                                      });
+
+        auto groupIndex = static_cast<std::size_t>( groupDef - msgDef.groups_.begin() );
+
+        isValid &= decodeGroup( message, msgDef, groupIndex, GroupRef::noParent, 0, pos, errors );
+    }
+
+    return isValid;
+}
+
+/**
+ * @brief Decode the repeating groups of the message as defined by the dictionary for its MsgType
+ * @return true if every group has as many entries as its NumInGroup field says, false otherwise
+ **/
+inline auto decodeGroups(FixMessage& message, const Dictionary& dictionary, ErrorBag& errors) -> bool {
+
+    auto msgDef = dictionary.message( message.getValue( 35 ) );
+
+    return !msgDef || decodeGroups( message, *msgDef, errors );
+}
+
+/**
+ * @brief Check the value of every field against the type of the field and its enum values
+ * @return true if every value is well formed and allowed, false otherwise
+ **/
+inline auto checkValues(const FixMessage& message, ErrorBag& errors) -> bool {
+
+    bool isValid{true};
+
+    for(const auto& field: message.fields_ ){
+
+        auto fieldInfo = message.dictionary_->info( field.number_ );
+        auto value = message.getValue( field );
+
+        Decimal decimal{};
+        std::int64_t number{};
+
+        bool isWellFormed = fieldInfo.kind_ == FieldKind::INT       ? parseInt( value, number ) :
+                            fieldInfo.kind_ == FieldKind::DECIMAL   ? parseDecimal( value, decimal ) :
+                            fieldInfo.kind_ == FieldKind::TIMESTAMP ? parseTimestamp( value, number ) :
+                            fieldInfo.kind_ == FieldKind::CHAR      ? value.size() == 1 : true;
+
+        if( !isWellFormed ){
+            errors.add( ErrorKind::INCORRECT_DATA_FORMAT, field.number_, tagBegin( field ) );
+            isValid = false;
+            continue;
+        }
+
+        if( fieldInfo.valueCount_ == 0 ){
+            continue;
+        }
+
+        // A MULTIPLEVALUESTRING holds several enum values separated by spaces
+        bool isAllowed{true};
+
+        if( fieldInfo.isMultipleValue_ ){
+
+            for(std::size_t begin{0}; begin <= value.size() && isAllowed; ){
+
+                auto end = std::min( value.find( ' ', begin ), value.size() );
+                isAllowed = message.dictionary_->isEnumValue( field.number_, value.substr( begin, end - begin ) );
+                begin = end + 1;
+            }
+
+        }else{
+            isAllowed = message.dictionary_->isEnumValue( field.number_, value );
+        }
+
+        if( !isAllowed ){
+            errors.add( ErrorKind::VALUE_OUT_OF_RANGE, field.number_, tagBegin( field ) );
+            isValid = false;
+        }
+    }
+
+    return isValid;
+}
+
+/**
+ * @brief Decoder specialized for one MsgType, run in place of categorize() and hasRequiredFields() for the hot
+ * MsgTypes of a parser. Every tag number maps to a code telling whether the dictionary defines it and which bit
+ * of the required mask it sets, a field then costs a single lookup and the required fields a single compare.
+ * A MsgType with more than 64 required fields, header and trailer included, can't be specialized.
+ * Only the tag numbers below denseTagLimit have a code, a message with a larger one goes through the generic stages
+ **/
+class MessageDecoder{
+
+    public:
+
+        static constexpr std::size_t maxRequired = 64;
+
+        MessageDecoder(const Dictionary& dictionary, const MessageDef& msgDef):
+            msgDef_(&msgDef), codes_(std::min( dictionary.maxNumber(), denseTagLimit - 1 ) + std::size_t{1}, undefined) {
+
+            for(TagNumber number{0}; number != codes_.size(); ++number ){
+                if( dictionary.info( number ).isDefined_ ){
+                    codes_[number] = optional;
+                }
+            }
+
+            std::size_t bit{};
+            bool hasSparseRequired{};
+
+            msgDef.allRequired_.forEach( [&](TagNumber number){
+
+                if( number >= codes_.size() ){
+                    hasSparseRequired = true;
+                    return;
+                }
+
+                if( bit < maxRequired ){
+                    codes_[number] = static_cast<std::uint8_t>( bit );
+                    requiredMask_ |= std::uint64_t{1} << bit;
+                }
+
+                ++bit;
+            });
+
+            isUsable_ = bit <= maxRequired && !hasSparseRequired;
+        }
+
+        auto isUsable() const noexcept -> bool {
+            return isUsable_;
+        }
+
+        auto msgDef() const noexcept -> const MessageDef& {
+            return *msgDef_;
+        }
+
+        /**
+         * @brief Append the tokenized fields to fixMsg as categorize() does, checking the required fields on the way
+         * @return true if every field is defined and no required field is missing. Nothing is reported otherwise,
+         * the message is then to go through the generic stages which tell what's wrong
+         **/
+        auto decode(std::string_view message, const FieldArray& fields, FixMessage& fixMsg) const -> bool {
+
+            std::uint64_t seen{};
+
+            for(const auto& field: fields ){
+
+                auto code = field.number_ < codes_.size() ? codes_[field.number_] : undefined;
+
+                if( code == undefined ){
+                    return false;
+                }
+
+                if( code != optional ){
+                    seen |= std::uint64_t{1} << code;
+                }
+
+                auto offset = static_cast<std::uint32_t>( field.value_.data() - message.data() );
+
+                fixMsg.fields_.emplace_back( FieldRef{ field.number_, static_cast<std::uint32_t>( field.value_.size() ), offset } );
+            }
+
+            return seen == requiredMask_;
+        }
+
+    private:
+
+        static constexpr std::uint8_t undefined = 0xFF;
+        static constexpr std::uint8_t optional = 0xFE;
+
+        const MessageDef* msgDef_;
+        std::vector<std::uint8_t> codes_;  // For each tag number, the bit of a required field or one of the two codes above
+        std::uint64_t requiredMask_{};
+        bool isUsable_{};
+};
+
+namespace metrics {
+
+// The instrumentation of the parser is compiled in with FIXPARSER_INSTRUMENTATION, without it the snapshots stay empty
+#ifdef FIXPARSER_INSTRUMENTATION
+inline constexpr bool enabled = true;
+#else
+inline constexpr bool enabled = false;
+#endif
+
+// The stages of Parser::checkMsgValidity() that are timed, TOTAL being the whole call
+enum class Stage : std::uint8_t {
+    SCAN,
+    TOKENIZE,
+    CATEGORIZE,
+    REQUIRED,
+    GROUPS,
+    BODY_LENGTH,
+    CHECKSUM,
+    VALUES,
+    TOTAL
+};
+
+inline constexpr std::size_t stageCount = 9;
+
+constexpr auto stageName(Stage stage) noexcept -> const char* {
+
+    switch( stage ){
+        case Stage::SCAN:        return "scan";
+        case Stage::TOKENIZE:    return "tokenize";
+        case Stage::CATEGORIZE:  return "categorize";
+        case Stage::REQUIRED:    return "required";
+        case Stage::GROUPS:      return "groups";
+        case Stage::BODY_LENGTH: return "bodyLength";
+        case Stage::CHECKSUM:    return "checkSum";
+        case Stage::VALUES:      return "values";
+        default:                 return "total";
+    }
+}
+
+/**
+ * @brief Ticks of the clock the stages are timed with, the TSC on x86 and the steady clock elsewhere.
+ * The ticks are turned into nanoseconds when a snapshot is taken
+ **/
+inline auto ticks() noexcept -> std::uint64_t {
+#ifdef FIXPARSER_X86_SIMD
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                       std::chrono::steady_clock::now().time_since_epoch() ).count() );
+#endif
+}
+
+// Log-linear buckets in the manner of HDR histograms, 8 buckets per power of two so within 12.5% of the value
+inline constexpr std::size_t subBuckets = 8;
+inline constexpr std::size_t bucketCount = 46 * subBuckets;
+
+constexpr auto bucketOf(std::uint64_t value) noexcept -> std::size_t {
+
+    if( value < subBuckets ){
+        return static_cast<std::size_t>( value );
+    }
+
+    std::size_t msb{3};
+
+    while( msb < 63 && ( value >> ( msb + 1 ) ) != 0 ){
+        ++msb;
+    }
+
+    auto bucket = ( msb - 2 ) * subBuckets + ( ( value >> ( msb - 3 ) ) & ( subBuckets - 1 ) );
+
+    return std::min( bucket, bucketCount - 1 );
+}
+
+/**
+ * @brief The first value past bucket
+ **/
+constexpr auto bucketLimit(std::size_t bucket) noexcept -> std::uint64_t {
+
+    if( bucket < subBuckets ){
+        return bucket + 1;
+    }
+
+    return ( subBuckets + bucket % subBuckets + 1 ) << ( bucket / subBuckets - 1 );
+}
+
+/**
+ * @brief Counter written by a single thread and read by any.
+ * The owner updates it with a plain load and store, a snapshot may see it a few counts behind but never torn
+ **/
+class Counter{
+
+    public:
+
+        auto add(std::uint64_t count = 1) noexcept -> void {
+            value_.store( value_.load( std::memory_order_relaxed ) + count, std::memory_order_relaxed );
+        }
+
+        auto load() const noexcept -> std::uint64_t {
+            return value_.load( std::memory_order_relaxed );
+        }
+
+    private:
+        std::atomic<std::uint64_t> value_{};
+};
+
+struct Histogram{
+    std::array<Counter, bucketCount> buckets_;
+    Counter sum_;
+
+    auto record(std::uint64_t ticks) noexcept -> void {
+        buckets_[ bucketOf( ticks ) ].add();
+        sum_.add( ticks );
+    }
+};
+
+// A MsgType of up to 4 characters packed in an integer, the others are counted as "?"
+constexpr auto packMsgType(std::string_view msgType) noexcept -> std::uint32_t {
+
+    if( msgType.empty() || msgType.size() > 4 ){
+        return '?';
+    }
 
-    int computedLength{};
+    std::uint32_t key{};
 
-    for(const auto& msg : message.body_.tagValues_ ){
-        computedLength += static_cast<int>( msg.value_.size() ) +
-                          static_cast<int>( (std::to_string( msg.number_ )).size() ) + 2; // 2 = the SOH plus the '=' in the message
+    for(auto c: msgType ){
+        key = ( key << 8 ) | static_cast<unsigned char>( c );
     }
 
-    for(const auto& msg : message.header_.headerFields_ ){
+    return key;
+}
+
+inline auto unpackMsgType(std::uint32_t key) -> std::string {
 
-        // We are excluding the tag 8 which contains the FIX version and the tag 9 which contains the body length
-        if( msg.number_ != 9 && msg.number_ != 8 ){
-            computedLength += static_cast<int>( msg.value_.size() ) +
-                            static_cast<int>( (std::to_string( msg.number_ )).size() ) + 2; // 2 = the SOH plus the '=' in the message
+    std::string msgType;
+
+    for(int shift{24}; shift >= 0; shift -= 8 ){
+        if( auto c = static_cast<char>( ( key >> shift ) & 0xFF ) ){
+            msgType += c;
         }
+    }
+
+    return msgType;
+}
+
+struct MsgTypeCounters{
+    std::atomic<std::uint32_t> key_{}; // 0 while the slot is free
+    Counter messages_;
+    Counter invalid_;
+};
 
+/**
+ * @brief The timings and counters of one thread, only this thread writes them
+ **/
+struct ThreadMetrics{
+    std::array<Histogram, stageCount> stages_;
+    std::array<MsgTypeCounters, 256> msgTypes_; // Open addressing on the packed MsgType
+    std::array<Counter, 256> errors_;           // Indexed by ErrorKind
+    std::atomic<bool> inUse_{};
+    std::uint64_t lap_{};                       // End of the last stage timed
+
+    auto record(Stage stage, std::uint64_t ticks) noexcept -> void {
+        stages_[ static_cast<std::size_t>( stage ) ].record( ticks );
+    }
+
+    /**
+     * @brief Record stage as ending now, it started when the previous stage ended.
+     * Reading the clock once per stage rather than twice halves the cost of the instrumentation
+     **/
+    auto lap(Stage stage) noexcept -> void {
+        auto now = ticks();
+        record( stage, now - lap_ );
+        lap_ = now;
     }
 
-    auto bodyLengthElem = std::find_if( message.header_.headerFields_.begin(),
-                                       message.header_.headerFields_.end(),
-                                        [](auto& elem){
-                                            return elem.number_ == 9;
-                                        });
+    auto countMessage(std::string_view msgType, const ErrorBag& errors, bool isValid) noexcept -> void {
+
+        auto key = packMsgType( msgType );
+
+        // Slots are only taken by this thread, the key is published before the counters are read by a snapshot
+        for(std::size_t probe{0}, slot = ( key * 2654435761u ) >> 24; probe != msgTypes_.size(); ++probe, slot = ( slot + 1 ) % msgTypes_.size() ){
+
+            auto& counters = msgTypes_[slot];
+            auto slotKey = counters.key_.load( std::memory_order_relaxed );
+
+            if( slotKey == 0 ){
+                counters.key_.store( key, std::memory_order_release );
+            }else if( slotKey != key ){
+                continue;
+            }
+
+            counters.messages_.add();
+
+            if( !isValid ){
+                counters.invalid_.add();
+            }
 
-    if( bodyLengthElem != message.header_.headerFields_.end() ){
-        auto f = *bodyLengthElem;
-        auto areOfEqualLength = std::atoi( f.value_.c_str() ) == computedLength;
+            break;
+        }
 
-        if( !areOfEqualLength ){
-            std::string errorMsg = "Message body length mismatch.\nExpected: ";
-                        errorMsg += std::to_string(computedLength);
-                        errorMsg += "\nGot: ";
-                        errorMsg += f.value_;
-            errorBag.errors_.emplace_back( Error{ std::move(errorMsg)} );
+        for(const auto& error: errors ){
+            errors_[ static_cast<std::size_t>( error.kind_ ) ].add();
         }
-        return areOfEqualLength;
     }
+};
 
-    return false;
-}
+// The latencies of a stage over every thread
+struct LatencySnapshot{
+    std::array<std::uint64_t, bucketCount> buckets_{};
+    std::uint64_t count_{};
+    std::uint64_t sumTicks_{};
+    double ticksPerNs_{1.0};
+
+    auto mean() const noexcept -> double {
+        return count_ == 0 ? 0.0 : static_cast<double>( sumTicks_ ) / static_cast<double>( count_ ) / ticksPerNs_;
+    }
+
+    /**
+     * @brief Latency in nanoseconds under which a fraction q of the calls fall, q being in [0, 1].
+     * The latency is the upper bound of the bucket reaching q
+     **/
+    auto percentile(double q) const noexcept -> double {
+
+        auto rank = static_cast<std::uint64_t>( q * static_cast<double>( count_ ) + 0.5 );
+        std::uint64_t seen{};
+
+        for(std::size_t bucket{0}; bucket != bucketCount; ++bucket ){
+
+            seen += buckets_[bucket];
+
+            if( seen != 0 && seen >= rank ){
+                return static_cast<double>( bucketLimit( bucket ) ) / ticksPerNs_;
+            }
+        }
+
+        return 0.0;
+    }
+};
+
+struct MsgTypeSnapshot{
+    std::string msgType_;
+    std::uint64_t messages_{};
+    std::uint64_t invalid_{};
+};
 
 /**
- * @brief Check if the message checksum is correct
- * @return true if the checksum is correct false otherwise
+ * @brief The metrics of every thread that validated a message, summed up
  **/
+struct Snapshot{
+    std::array<LatencySnapshot, stageCount> stages_;
+    std::vector<MsgTypeSnapshot> msgTypes_;
+    std::array<std::uint64_t, 256> errors_{};
 
-template<typename T,typename=std::enable_if_t<std::is_same_v<std::decay_t<T>, FixMessage> > >
-constexpr auto checkCheckSum(T&& message, Config& config) noexcept -> bool {
-
-    // We assume that the trailer only contains one field which is the checksum
-    // While checking the FIX spec we discovered that other fields in the trailer are deprecated
-    auto csSize = message.trailer_.trailer_.at(0).value_.size() == 3;
- 
-    if( !csSize ){
-        errorBag.errors_.emplace_back( Error{"The checksum size is invalid. It should be 3"});
-        return false;
+    auto stage(Stage stage) const noexcept -> const LatencySnapshot& {
+        return stages_[ static_cast<std::size_t>( stage ) ];
     }
 
-    uint16_t computedCheckSum{};
-    int countSoh{0};
+    auto errorCount(ErrorKind kind) const noexcept -> std::uint64_t {
+        return errors_[ static_cast<std::size_t>( kind ) ];
+    }
+};
 
-    // The loop is going till the size() - 7, 7=number of characters in the trailing tag of the message
-    for(int i{0}; i != message.rawMsg_.size() - 7; ++i){
+/**
+ * @brief The metrics of every thread, a thread takes its own on its first message and gives it back when it ends.
+ * The metrics of the threads that ended are kept, the next thread starting takes them over
+ **/
+class Registry{
 
-        if( config.getSOH() != message.rawMsg_.at(i) ){
-            computedCheckSum += message.rawMsg_.at(i);
-        }else{
-            ++countSoh;
+    public:
+
+        Registry(): startTicks_(ticks()), startTime_(std::chrono::steady_clock::now()) {}
+
+        auto acquire() -> ThreadMetrics* {
+
+            std::lock_guard<std::mutex> lock( mutex_ );
+
+            for(auto& threadMetrics: threads_ ){
+                if( !threadMetrics->inUse_.load( std::memory_order_relaxed ) ){
+                    threadMetrics->inUse_.store( true, std::memory_order_relaxed );
+                    return threadMetrics.get();
+                }
+            }
+
+            threads_.emplace_back( std::make_unique<ThreadMetrics>() );
+            threads_.back()->inUse_.store( true, std::memory_order_relaxed );
+
+            return threads_.back().get();
+        }
+
+        auto release(ThreadMetrics* threadMetrics) noexcept -> void {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            threadMetrics->inUse_.store( false, std::memory_order_relaxed );
         }
-    }
 
-    computedCheckSum = (computedCheckSum + countSoh)%256;
-    auto computedCheckSumStr = std::to_string( computedCheckSum );
+        /**
+         * @brief Sum the metrics of every thread into snapshot, reusing its buffers.
+         * The threads are never stopped, only the registration of a new thread waits for the snapshot
+         **/
+        auto snapshot(Snapshot& snapshot) -> void {
 
-    // In a FIX message the checksum size need to be 3, hence the 3 in the following lines
-    // After the computation of the checksum when we obtain result like 1 we need to add two 
-    // zeros in front so it becomes 001, and for the case when it's 2 digits like 12 we need 
-    // to add one zero in front so 012
+            // The TSC is calibrated against the steady clock over the lifetime of the registry
+            auto elapsed = std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - startTime_ ).count();
+            auto ticksPerNs = elapsed > 0 ? static_cast<double>( ticks() - startTicks_ ) / elapsed : 1.0;
 
-    if( computedCheckSumStr.size() < 3 ){
-        computedCheckSumStr = std::string( 3 - computedCheckSumStr.size(), '0') + computedCheckSumStr;
-    }
+            for(auto& stage: snapshot.stages_ ){
+                stage = LatencySnapshot{};
+                stage.ticksPerNs_ = ticksPerNs > 0 ? ticksPerNs : 1.0;
+            }
 
-    if( computedCheckSumStr != message.trailer_.trailer_.at(0).value_ ){
+            snapshot.msgTypes_.clear();
+            snapshot.errors_.fill( 0 );
 
-        std::string errMsg = "The message checksum is invalid.\nExpected: " + computedCheckSumStr + "\nGot: " + message.trailer_.trailer_.at(0).value_+ "\n";
-        errorBag.errors_.emplace_back( Error{std::move(errMsg)});
-        return false;
+            std::lock_guard<std::mutex> lock( mutex_ );
+
+            for(const auto& threadMetrics: threads_ ){
+
+                for(std::size_t i{0}; i != stageCount; ++i ){
+
+                    auto& stage = snapshot.stages_[i];
+                    const auto& histogram = threadMetrics->stages_[i];
+
+                    for(std::size_t bucket{0}; bucket != bucketCount; ++bucket ){
+                        auto count = histogram.buckets_[bucket].load();
+                        stage.buckets_[bucket] += count;
+                        stage.count_ += count;
+                    }
+
+                    stage.sumTicks_ += histogram.sum_.load();
+                }
+
+                for(const auto& counters: threadMetrics->msgTypes_ ){
+
+                    auto key = counters.key_.load( std::memory_order_acquire );
+
+                    if( key == 0 ){
+                        continue;
+                    }
+
+                    auto msgType = unpackMsgType( key );
+                    auto found = std::find_if( snapshot.msgTypes_.begin(), snapshot.msgTypes_.end(),
+                                               [&msgType](const auto& entry){ return entry.msgType_ == msgType; } );
+
+                    if( found == snapshot.msgTypes_.end() ){
+                        found = snapshot.msgTypes_.insert( found, MsgTypeSnapshot{ std::move(msgType), 0, 0 } );
+                    }
+
+                    found->messages_ += counters.messages_.load();
+                    found->invalid_ += counters.invalid_.load();
+                }
+
+                for(std::size_t kind{0}; kind != snapshot.errors_.size(); ++kind ){
+                    snapshot.errors_[kind] += threadMetrics->errors_[kind].load();
+                }
+            }
+
+            std::sort( snapshot.msgTypes_.begin(), snapshot.msgTypes_.end(),
+                       [](const auto& lhs, const auto& rhs){ return lhs.msgType_ < rhs.msgType_; } );
+        }
+
+    private:
+        std::mutex mutex_;
+        std::vector<std::unique_ptr<ThreadMetrics>> threads_;
+        std::uint64_t startTicks_;
+        std::chrono::steady_clock::time_point startTime_;
+};
+
+inline auto registry() -> Registry& {
+    static Registry registry;
+    return registry;
+}
+
+/**
+ * @brief The metrics of the calling thread
+ **/
+inline auto local() -> ThreadMetrics& {
+
+    struct Handle{
+        Handle(): threadMetrics_(registry().acquire()) {}
+        ~Handle(){ registry().release( threadMetrics_ ); }
+        ThreadMetrics* threadMetrics_;
+    };
+
+    thread_local Handle handle;
+    return *handle.threadMetrics_;
+}
+
+/**
+ * @brief Run f and time it as stage on the calling thread, from the end of the previous stage
+ **/
+template <typename F>
+auto timed(Stage stage, F&& f) -> decltype( f() ) {
+
+    if constexpr( std::is_void_v<decltype( f() )> ){
+        f();
+        local().lap( stage );
+    }else{
+        auto result = f();
+        local().lap( stage );
+        return result;
     }
+}
 
-    return true;
+/**
+ * @brief Sum the metrics of every thread, cheap enough to be polled by an exporter
+ **/
+inline auto snapshot(Snapshot& into) -> void {
+    registry().snapshot( into );
+}
+
+inline auto snapshot() -> Snapshot {
+    Snapshot into;
+    snapshot( into );
+    return into;
+}
+
+}// namespace metrics
+
+// A stage of the validation, timed only when the instrumentation is compiled in
+#ifdef FIXPARSER_INSTRUMENTATION
+    #define FIXPARSER_TIMED(stage, ...) ::fixparser::metrics::timed( ::fixparser::metrics::Stage::stage, [&](){ return __VA_ARGS__; } )
+#else
+    #define FIXPARSER_TIMED(stage, ...) ( __VA_ARGS__ )
+#endif
+
+/**
+ * @brief Parsing state owning everything a parse produces: the tokenized fields, the resulting message and the errors.
+ * A parser is meant to be used by a single thread, the dictionary it holds is immutable and can be shared
+ * by as many parsers as needed, e.g one parser per thread all sharing the same dictionary without any locking.
+ * The buffers are kept between two messages so a parser reused over a stream of messages stops allocating for them.
+ * They're allocated from the memory resource given at construction, the default one if none is
+ **/
+class Parser{
+
+    public:
+
+        Parser() = default;
+
+        explicit Parser(std::shared_ptr<const Dictionary> dictionary, const char soh='|',
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource()): Parser(resource) {
+            dictionary_ = std::move(dictionary);
+            soh_ = soh;
+        }
+
+        /**
+         * @brief Parser checking each message with the dictionary of its version
+         **/
+        explicit Parser(std::shared_ptr<const DictionaryRegistry> registry, const char soh='|',
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource()): Parser(resource) {
+            registry_ = std::move(registry);
+            soh_ = soh;
+        }
+
+        explicit Parser(Config& config, std::pmr::memory_resource* resource = std::pmr::get_default_resource()):
+            Parser(config, dictionaryOf( config ), resource) {}
+
+        /**
+         * @brief Parser with the settings of config checking the messages with dictionary, resolved once from config
+         * beforehand, e.g so that the parsers of several threads never load the dictionary of a shared config
+         **/
+        Parser(const Config& config, std::shared_ptr<const Dictionary> dictionary,
+               std::pmr::memory_resource* resource = std::pmr::get_default_resource()): Parser(resource) {
+            dictionary_ = std::move(dictionary);
+            registry_ = config.getRegistry();
+            soh_ = config.getSOH();
+            validation_ = config.getValidation();
+            hotMsgTypes_ = config.getHotMsgTypes();
+        }
+
+        /**
+         * @brief Size the buffers for messages of up to fieldCount fields, so that the first messages don't have to grow them
+         **/
+        auto reserve(std::size_t fieldCount) -> void {
+            index_.positions_.reserve( 2 * fieldCount );
+            fields_.reserve( fieldCount );
+            message_.fields_.reserve( fieldCount );
+            message_.groups_.reserve( fieldCount / 2 );
+            message_.slots_.reserve( fieldCount );
+        }
+
+        /**
+         * @brief Decode the messages of type msgType with a decoder specialized for it, see Config::addHotMsgType()
+         **/
+        auto specialize(std::string_view msgType) -> void {
+
+            if( std::find( hotMsgTypes_.begin(), hotMsgTypes_.end(), msgType ) == hotMsgTypes_.end() ){
+                hotMsgTypes_.emplace_back( msgType );
+                decoders_.clear();
+            }
+        }
+
+        /**
+         * @brief Use the dictionary, SOH, validation levels and hot MsgTypes of config for the next messages
+         **/
+        auto configure(Config& config) -> void {
+
+            if( dictionary_ != dictionaryOf( config ) ){
+                dictionary_ = dictionaryOf( config );
+                decoders_.clear();
+            }
+
+            if( registry_ != config.getRegistry() ){
+                registry_ = config.getRegistry();
+                decoders_.clear();
+            }
+
+            if( hotMsgTypes_ != config.getHotMsgTypes() ){
+                hotMsgTypes_ = config.getHotMsgTypes();
+                decoders_.clear();
+            }
+
+            soh_ = config.getSOH();
+
+            // Only copied when changed, configure() is called for every message by the free functions
+            if( validation_.level_ != config.getValidation().level_ || validation_.overrides_ != config.getValidation().overrides_ ){
+                validation_ = config.getValidation();
+            }
+        }
+
+        /**
+         * @brief Check the message validity over the dictionary of this parser
+         * @return true if the message is correct false otherwise
+         * The previous message and its errors are discarded first, when it returns false
+         * the list of errors encountered can be get via getErrors().
+         * The parsed message refers to message, which must outlive it (see store()).
+         * It throws std::bad_alloc if the buffers of the parser cannot grow for the message
+         **/
+        auto checkMsgValidity(std::string_view message) -> bool {
+
+#ifdef FIXPARSER_INSTRUMENTATION
+            auto& threadMetrics = metrics::local();
+            auto start = metrics::ticks();
+
+            threadMetrics.lap_ = start;
+
+            auto isValid = validate( message );
+
+            threadMetrics.record( metrics::Stage::TOTAL, metrics::ticks() - start );
+            threadMetrics.countMessage( message_.getValue( 35 ), errors_, isValid );
+
+            return isValid;
+#else
+            return validate( message );
+#endif
+        }
+
+        /**
+         * @brief Copy message into the buffer owned by the parser, for callers that can't keep it alive
+         * @return a view of the copy, valid until the next call to store()
+         **/
+        auto store(std::string_view message) -> std::string_view {
+            storage_.assign( message.data(), message.size() );
+            return storage_;
+        }
+
+        /**
+         * @brief Discard the last message and its errors, keeping the allocated buffers
+         **/
+        auto reset() noexcept -> void {
+            errors_.clear();
+            message_.reset( {}, dictionary_.get() );
+        }
+
+        /**
+         * @brief Retrieve the list of errors that occured while parsing the last message
+         **/
+        auto getErrors() const noexcept -> const ErrorBag& {
+            return errors_;
+        }
+
+        /**
+         * @brief The last parsed message, only complete when checkMsgValidity() returned true
+         **/
+        auto getMessage() const noexcept -> const FixMessage& {
+            return message_;
+        }
+
+        auto getDictionary() const noexcept -> const std::shared_ptr<const Dictionary>& {
+            return dictionary_;
+        }
+
+        /**
+         * @brief Print the last message in a human readable way, or its errors if it's not a valid one
+         **/
+        auto toHuman() const -> void {
+
+            if( !errors_.isEmpty() ){
+                std::cerr << "The message contains some errors, please check the FIX specification to get the list of correct fields \n\n";
+                std::cerr << errors_ << "\n\n";
+                return;
+            }
+
+            prettyPrint( message_ );
+        }
+
+        /**
+         * @brief Render the last message, or its errors if it's not a valid one, at the end of text.
+         * Nothing is written to a stream, so that the text can be logged by another thread
+         **/
+        auto toHuman(std::string& text, HumanFormat format = HumanFormat::PRETTY) const -> void {
+            TextSink out( text );
+            render( out, format );
+        }
+
+        /**
+         * @brief Render the last message, or its errors, in buffer. The text isn't null terminated and is cut if it doesn't fit
+         * @return the length of the whole text, above size when it was cut
+         **/
+        auto toHuman(char* buffer, std::size_t size, HumanFormat format = HumanFormat::PRETTY) const -> std::size_t {
+            TextSink out( buffer, size );
+            render( out, format );
+            return out.size();
+        }
+
+    private:
+
+        explicit Parser(std::pmr::memory_resource* resource): index_{ std::pmr::vector<std::uint32_t>( resource ), 0 }, fields_(resource),
+                                                              message_(resource), storage_(resource) {}
+
+        auto render(TextSink& out, HumanFormat format) const -> void {
+
+            if( errors_.isEmpty() ){
+                fixparser::toHuman( message_, out, format );
+                return;
+            }
+
+            // The pretty text is the one of operator<<(std::ostream&, const ErrorBag&)
+            if( format == HumanFormat::PRETTY ){
+                out.append( "A total of " );
+                out.appendNumber( errors_.size_ + errors_.dropped_ );
+                out.append( " error(s) found \n\n" );
+            }else if( format == HumanFormat::JSON ){
+                out.append( "{\"errors\":[" );
+            }
+
+            for(std::size_t i{0}; i != errors_.size(); ++i ){
+
+                const auto& error = errors_[i];
+                auto text = errors_.describe( error );
+
+                switch( format ){
+
+                    case HumanFormat::PRETTY:
+                        out.append( text );
+                        out.append( '\n' );
+                        break;
+
+                    case HumanFormat::ONE_LINE:
+
+                        while( !text.empty() && text.back() == '\n' ){
+                            text.pop_back();
+                        }
+
+                        std::replace( text.begin(), text.end(), '\n', ' ' );
+
+                        out.append( i == 0 ? "" : " | " );
+                        out.append( text );
+                        break;
+
+                    case HumanFormat::JSON:
+                        out.append( i == 0 ? "{\"reason\":" : ",{\"reason\":" );
+                        out.appendNumber( rejectReason( error.kind_ ) );
+                        out.append( ",\"tag\":" );
+                        out.appendNumber( error.tag_ );
+                        out.append( ",\"text\":\"" );
+                        out.appendEscaped( text );
+                        out.append( "\"}" );
+                        break;
+                }
+            }
+
+            if( format == HumanFormat::PRETTY && errors_.dropped_ != 0 ){
+                out.append( "... and " );
+                out.appendNumber( errors_.dropped_ );
+                out.append( " more\n" );
+            }else if( format == HumanFormat::JSON ){
+                out.append( "]}" );
+            }
+        }
+
+        auto validate(std::string_view message) -> bool {
+
+            reset();
+
+            // With a registry the dictionary is the one of the version of the message
+            auto dictionary = registry_ ? registry_->select( message, soh_ ) : dictionary_.get();
+
+            errors_.reset( message, dictionary, soh_ );
+            message_.reset( message, dictionary );
+
+            FIXPARSER_TIMED( SCAN, scanDelimiters( message, soh_, index_ ) );
+            FIXPARSER_TIMED( TOKENIZE, tokenize( message, soh_, index_, fields_ ) );
+
+            auto level = levelOf( fields_ );
+
+            // The stages of the levels above the one of the message aren't run at all, those below STRUCTURE
+            // don't need the dictionary, the fields are taken as tokenized
+            if( level < ValidationLevel::STRUCTURE ){
+
+                FIXPARSER_TIMED( CATEGORIZE, collectFields( message, fields_, message_ ) );
+
+                return level == ValidationLevel::NONE ||
+                       ( FIXPARSER_TIMED( BODY_LENGTH, checkBodyLength( message_, errors_ ) ) &&
+                         ( level == ValidationLevel::FRAMING ||
+                           FIXPARSER_TIMED( CHECKSUM, checkCheckSum( message_, soh_, index_.byteSum_, errors_ ) ) ) );
+            }
+
+            if( !dictionary ){
+                errors_.add( registry_ ? ErrorKind::UNSUPPORTED_VERSION : ErrorKind::NO_DICTIONARY, registry_ ? 8 : 0 );
+                return false;
+            }
+
+            // A hot MsgType is categorized and checked in one pass, the generic stages are only run when it fails to tell why
+            if( auto decoder = decoderOf( *dictionary, fields_ ) ){
+
+                if( FIXPARSER_TIMED( CATEGORIZE, decoder->decode( message, fields_, message_ ) ) ){
+                    return FIXPARSER_TIMED( GROUPS, decodeGroups( message_, decoder->msgDef(), errors_ ) ) && checkFraming( level );
+                }
+
+                message_.fields_.clear();
+            }
+
+            return FIXPARSER_TIMED( CATEGORIZE, categorize( message, fields_, *dictionary, message_, errors_ ) ) &&
+                   FIXPARSER_TIMED( REQUIRED, hasRequiredFields( message_, *dictionary, seen_, errors_ ) ) &&
+                   FIXPARSER_TIMED( GROUPS, decodeGroups( message_, *dictionary, errors_ ) ) &&
+                   checkFraming( level );
+        }
+
+        // The stages run once the structure of the message is checked
+        auto checkFraming(ValidationLevel level) -> bool {
+            return FIXPARSER_TIMED( BODY_LENGTH, checkBodyLength( message_, errors_ ) ) &&
+                   FIXPARSER_TIMED( CHECKSUM, checkCheckSum( message_, soh_, index_.byteSum_, errors_ ) ) &&
+                   ( level != ValidationLevel::FULL || FIXPARSER_TIMED( VALUES, checkValues( message_, errors_ ) ) );
+        }
+
+        // The decoder of the MsgType of the message if it's a hot one. The decoders of a dictionary are built the first
+        // time one of its messages is met
+        auto decoderOf(const Dictionary& dictionary, const FieldArray& fields) -> const MessageDecoder* {
+
+            if( hotMsgTypes_.empty() ){
+                return nullptr;
+            }
+
+            auto msgType = std::find_if( fields.begin(), fields.end(), [](const auto& field){ return field.number_ == 35; } );
+
+            if( msgType == fields.end() ){
+                return nullptr;
+            }
+
+            auto specialized = std::find_if( decoders_.begin(), decoders_.end(), [&](const auto& entry){
+                                                 return entry.first == &dictionary;
+                                             });
+
+            if( specialized == decoders_.end() ){
+
+                std::vector<MessageDecoder> decoders;
+
+                for(const auto& hotMsgType: hotMsgTypes_ ){
+                    if( auto msgDef = dictionary.message( hotMsgType ) ){
+                        if( MessageDecoder decoder( dictionary, *msgDef ); decoder.isUsable() ){
+                            decoders.emplace_back( std::move(decoder) );
+                        }
+                    }
+                }
+
+                specialized = decoders_.emplace( decoders_.end(), &dictionary, std::move(decoders) );
+            }
+
+            for(const auto& decoder: specialized->second ){
+                if( decoder.msgDef().msgType_ == msgType->value_ ){
+                    return &decoder;
+                }
+            }
+
+            return nullptr;
+        }
+
+        // The validation level of the message, its MsgType is only looked for when some types have their own level
+        // The dictionary of config, only loaded when some messages are checked up to their structure
+        static auto dictionaryOf(Config& config) -> const std::shared_ptr<const Dictionary>& {
+            return config.getValidation().needsDictionary() ? config.getDictionary() : config.getLoadedDictionary();
+        }
+
+        auto levelOf(const FieldArray& fields) const noexcept -> ValidationLevel {
+
+            if( validation_.overrides_.empty() ){
+                return validation_.level_;
+            }
+
+            for(const auto& field: fields ){
+                if( field.number_ == 35 ){
+                    return validation_.levelOf( field.value_ );
+                }
+            }
+
+            return validation_.level_;
+        }
+
+        std::shared_ptr<const Dictionary> dictionary_;
+        std::shared_ptr<const DictionaryRegistry> registry_;
+        char soh_{'|'};
+        ValidationProfile validation_;
+        std::vector<std::string> hotMsgTypes_;
+        std::vector<std::pair<const Dictionary*, std::vector<MessageDecoder>>> decoders_; // The decoders of every dictionary met
+        DelimiterIndex index_;
+        FieldArray fields_;
+        TagSet seen_;
+        FixMessage message_;
+        ErrorBag errors_;
+        std::pmr::string storage_;
+};
+
+/**
+ * @brief The parser used by the free functions below, there's one per thread
+ **/
+inline auto defaultParser() -> Parser& {
+    thread_local Parser parser;
+    return parser;
+}
+
+/**
+ * @brief Check the message validity over a Fix specification
+ *       if none is specified the FIX44 standard is used
+ * @return true if the message is correct false otherwise
+ * When it returns false, the list of errors encountered can be get via the getErrors() method
+ * and be displayed e.g: std::cout << fixparser::getErrors() << "\n"
+*/
+template <typename T,typename=std::enable_if_t<std::is_convertible_v<std::decay_t<T>, std::string_view> > >
+auto checkMsgValidity(T&& message, Config& config) -> bool {
+
+    auto& parser = defaultParser();
+    parser.configure( config );
+
+    // The message is copied since fixToHuman() may be called once the caller's one is gone
+    return parser.checkMsgValidity( parser.store( std::forward<T>(message) ) );
+}
+
+/**
+ * @brief Retrieve the list of errors that occured while parsing the last message on this thread
+ * @return ErrorBag
+ **/
+inline auto getErrors() -> const ErrorBag& {
+     return defaultParser().getErrors();
 }
 
 /**
@@ -717,7 +4138,11 @@ constexpr auto checkCheckSum(T&& message, Config& config) noexcept -> bool {
 
 template<typename T=void>
 constexpr auto fixToHuman() -> void {
-    return prettyPrint( fixMessage );
+    defaultParser().toHuman();
 }
 
 }// namespace fixparser
+
+#ifdef FIXPARSER_FIX44_TABLES
+#include "fixparser_fix44.hpp"
+#endif
@@ -0,0 +1,305 @@
+#pragma once
+
+#include "fixparser.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <thread>
+
+namespace fixparser {
+
+/**
+ * @brief Outcome of a batch validation, one entry per message in the order of the batch.
+ * It's sized once for the batch and can be reused by the next one, the error bags of the valid messages stay empty.
+ * The error bags refer to the messages of the batch, which must outlive them for their errors to be described
+ **/
+struct BatchResult{
+    std::vector<char> valid_; // char rather than bool so that workers can write neighbouring entries concurrently
+    std::vector<ErrorBag> errors_;
+
+    auto resize(std::size_t count) -> void {
+        valid_.assign( count, 0 );
+        errors_.resize( count );
+    }
+
+    auto invalidCount() const noexcept -> std::size_t {
+        return static_cast<std::size_t>( std::count( valid_.begin(), valid_.end(), 0 ) );
+    }
+};
+
+/**
+ * @brief Pool of workers validating batches of messages with a shared dictionary.
+ * Each worker owns a parser and a range of the batch, once its range is done it steals half of the
+ * remaining range of another worker. The thread calling validate() takes part as the first worker
+ **/
+class BatchValidator{
+
+    public:
+
+        explicit BatchValidator(Config& config, std::size_t workers = std::thread::hardware_concurrency()){
+
+            workers = std::max<std::size_t>( workers, 1 );
+
+            // Every parser shares the dictionary, loading it here keeps the workers away from the config
+            parsers_.reserve( workers );
+            ranges_ = std::make_unique<WorkRange[]>( workers );
+
+            for(std::size_t i{0}; i != workers; ++i ){
+                parsers_.emplace_back( config );
+            }
+
+            // The workers already started are stopped if one of them cannot be, the destructor won't run
+            try{
+                for(std::size_t i{1}; i != workers; ++i ){
+                    threads_.emplace_back( [this, i](){ run( i ); } );
+                }
+            }catch(...){
+                stop();
+                throw;
+            }
+        }
+
+        BatchValidator(const BatchValidator&) = delete;
+        BatchValidator& operator=(const BatchValidator&) = delete;
+
+        ~BatchValidator(){
+            stop();
+        }
+
+        auto workers() const noexcept -> std::size_t {
+            return parsers_.size();
+        }
+
+        /**
+         * @brief Validate count messages, result is resized to count and filled at the index of each message.
+         * An exception thrown while validating, e.g std::bad_alloc, is rethrown once every worker is done
+         **/
+        auto validate(const std::string_view* messages, std::size_t count, BatchResult& result) -> void {
+
+            result.resize( count );
+
+            // The bounds of the ranges are 32 bits, a larger batch is validated in several rounds
+            for(std::size_t first{0}; first < count; first += maxRound ){
+                validateRound( messages, first, std::min( count - first, maxRound ), result );
+            }
+        }
+
+        auto validate(const std::vector<std::string_view>& messages, BatchResult& result) -> void {
+            validate( messages.data(), messages.size(), result );
+        }
+
+    private:
+
+        // Messages taken at once by a worker from its own range
+        static constexpr std::uint64_t grain = 64;
+
+        // Messages validated in one round, the most the 32 bits bounds of a range can hold
+        static constexpr std::size_t maxRound = UINT32_MAX;
+
+        // The bounds of a range are packed in one word so that the owner and the thieves update them with a single CAS
+        struct alignas(64) WorkRange{
+            std::atomic<std::uint64_t> range_{};
+        };
+
+        static constexpr auto pack(std::uint64_t begin, std::uint64_t end) noexcept -> std::uint64_t {
+            return begin | ( end << 32 );
+        }
+
+        static constexpr auto begin(std::uint64_t range) noexcept -> std::uint64_t {
+            return range & 0xFFFFFFFFu;
+        }
+
+        static constexpr auto end(std::uint64_t range) noexcept -> std::uint64_t {
+            return range >> 32;
+        }
+
+        auto stop() -> void {
+
+            {
+                std::lock_guard<std::mutex> lock( mutex_ );
+                stopping_ = true;
+            }
+
+            wakeUp_.notify_all();
+
+            for(auto& thread: threads_ ){
+                thread.join();
+            }
+
+            threads_.clear();
+        }
+
+        // Validate the count messages from first, count being at most maxRound
+        auto validateRound(const std::string_view* messages, std::size_t first, std::size_t count, BatchResult& result) -> void {
+
+            // The batch is split evenly, the stealing evens out what's left
+            auto share = count / workers() + 1;
+
+            for(std::size_t i{0}; i != workers(); ++i ){
+                auto begin = std::min( count, i * share );
+                auto end = std::min( count, begin + share );
+                ranges_[i].range_.store( pack( begin, end ), std::memory_order_relaxed );
+            }
+
+            {
+                std::lock_guard<std::mutex> lock( mutex_ );
+                messages_ = messages + first;
+                first_ = first;
+                result_ = &result;
+                failure_ = nullptr;
+                running_ = workers();
+                ++generation_;
+            }
+
+            wakeUp_.notify_all();
+
+            work( 0 );
+
+            std::unique_lock<std::mutex> lock( mutex_ );
+            done_.wait( lock, [this](){ return running_ == 0; } );
+
+            if( failure_ ){
+                std::rethrow_exception( failure_ );
+            }
+        }
+
+        auto run(std::size_t worker) -> void {
+
+            std::uint64_t seenGeneration{};
+
+            while( true ){
+
+                {
+                    std::unique_lock<std::mutex> lock( mutex_ );
+                    wakeUp_.wait( lock, [&](){ return stopping_ || generation_ != seenGeneration; } );
+
+                    if( stopping_ ){
+                        return;
+                    }
+
+                    seenGeneration = generation_;
+                }
+
+                work( worker );
+            }
+        }
+
+        auto work(std::size_t worker) -> void {
+
+            auto& parser = parsers_[worker];
+            std::uint64_t first{};
+            std::uint64_t last{};
+
+            std::exception_ptr failure;
+
+            try{
+                while( take( worker, first, last ) || steal( worker, first, last ) ){
+
+                    for(auto i = first; i != last; ++i ){
+
+                        auto isValid = parser.checkMsgValidity( messages_[i] );
+
+                        result_->valid_[first_ + i] = isValid;
+
+                        if( !isValid ){
+                            result_->errors_[first_ + i] = parser.getErrors();
+                        }else{
+                            result_->errors_[first_ + i].clear();
+                        }
+                    }
+                }
+            }catch(...){
+                failure = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock( mutex_ );
+
+            // The first failure is the one rethrown, the other workers go on with what's left
+            if( failure && !failure_ ){
+                failure_ = failure;
+            }
+
+            if( --running_ == 0 ){
+                done_.notify_one();
+            }
+        }
+
+        // Take the next messages from the front of the worker's own range
+        auto take(std::size_t worker, std::uint64_t& first, std::uint64_t& last) noexcept -> bool {
+
+            auto& range = ranges_[worker].range_;
+            auto current = range.load( std::memory_order_acquire );
+
+            while( begin( current ) < end( current ) ){
+
+                auto taken = std::min( begin( current ) + grain, end( current ) );
+
+                if( range.compare_exchange_weak( current, pack( taken, end( current ) ), std::memory_order_acq_rel ) ){
+                    first = begin( current );
+                    last = taken;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // Move the back half of another worker's range into the worker's own range and take from it
+        auto steal(std::size_t worker, std::uint64_t& first, std::uint64_t& last) noexcept -> bool {
+
+            for(std::size_t offset{1}; offset != workers(); ++offset ){
+
+                auto& victim = ranges_[ (worker + offset) % workers() ].range_;
+                auto current = victim.load( std::memory_order_acquire );
+
+                while( begin( current ) < end( current ) ){
+
+                    auto remaining = end( current ) - begin( current );
+                    auto stolenBegin = end( current ) - ( remaining + 1 ) / 2;
+
+                    if( victim.compare_exchange_weak( current, pack( begin( current ), stolenBegin ), std::memory_order_acq_rel ) ){
+                        ranges_[worker].range_.store( pack( stolenBegin, end( current ) ), std::memory_order_release );
+                        return take( worker, first, last );
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        std::vector<Parser> parsers_;
+        std::unique_ptr<WorkRange[]> ranges_;
+        std::vector<std::thread> threads_;
+
+        std::mutex mutex_;
+        std::condition_variable wakeUp_;
+        std::condition_variable done_;
+        std::uint64_t generation_{};
+        std::size_t running_{};
+        bool stopping_{};
+
+        const std::string_view* messages_{}; // The messages of the round, the ranges are indexes in it
+        std::size_t first_{};                // Index in the batch of the first message of the round
+        BatchResult* result_{};
+        std::exception_ptr failure_;
+};
+
+/**
+ * @brief Validate a batch of messages on a pool of workers sharing the dictionary of config.
+ * A pool is created for the call, keep a BatchValidator around to validate several batches
+ **/
+inline auto validateBatch(const std::string_view* messages, std::size_t count, Config& config, BatchResult& result,
+                          std::size_t workers = std::thread::hardware_concurrency()) -> void {
+
+    BatchValidator validator( config, workers );
+    validator.validate( messages, count, result );
+}
+
+inline auto validateBatch(const std::vector<std::string_view>& messages, Config& config, BatchResult& result,
+                          std::size_t workers = std::thread::hardware_concurrency()) -> void {
+
+    validateBatch( messages.data(), messages.size(), config, result, workers );
+}
+
+}// namespace fixparser
@@ -0,0 +1,343 @@
+#pragma once
+
+#include "fixparser.hpp"
+
+#include <deque>
+#include <map>
+
+namespace fixparser {
+
+enum class BookSide : char {
+    BID,
+    OFFER
+};
+
+// An aggregated level of a book, the price is a number of ticks of 10^-priceScale
+struct PriceLevel{
+    std::int64_t price_{};
+    Decimal size_{};
+};
+
+/**
+ * @brief Price levels of one instrument, each side kept in a flat sorted array.
+ * The best level is stored last so that the updates near the top of the book, the most frequent ones, move few levels
+ **/
+class Book{
+
+    public:
+
+        auto bidCount() const noexcept -> std::size_t {
+            return bids_.size();
+        }
+
+        auto offerCount() const noexcept -> std::size_t {
+            return offers_.size();
+        }
+
+        /**
+         * @brief Level at depth on a side, 0 being the best one. depth must be below the count of the side
+         **/
+        auto bid(std::size_t depth) const noexcept -> const PriceLevel& {
+            return bids_[bids_.size() - 1 - depth];
+        }
+
+        auto offer(std::size_t depth) const noexcept -> const PriceLevel& {
+            return offers_[offers_.size() - 1 - depth];
+        }
+
+        auto isEmpty() const noexcept -> bool {
+            return bids_.empty() && offers_.empty();
+        }
+
+        /**
+         * @brief Remove every level, keeping the memory of the arrays
+         **/
+        auto clear() noexcept -> void {
+            bids_.clear();
+            offers_.clear();
+        }
+
+        /**
+         * @brief Set the size of the level at price, adding the level if it's not in the book
+         **/
+        auto set(BookSide side, std::int64_t price, Decimal size) -> void {
+
+            auto& levels = levelsOf( side );
+            auto found = locate( side, price );
+
+            if( found != levels.end() && found->price_ == price ){
+                found->size_ = size;
+            }else{
+                levels.insert( found, PriceLevel{ price, size } );
+            }
+        }
+
+        /**
+         * @return false if there was no level at price
+         **/
+        auto remove(BookSide side, std::int64_t price) -> bool {
+
+            auto& levels = levelsOf( side );
+            auto found = locate( side, price );
+
+            if( found == levels.end() || found->price_ != price ){
+                return false;
+            }
+
+            levels.erase( found );
+            return true;
+        }
+
+    private:
+
+        auto levelsOf(BookSide side) noexcept -> std::vector<PriceLevel>& {
+            return side == BookSide::BID ? bids_ : offers_;
+        }
+
+        // First level at or after price in the order of the side, bids ascending and offers descending
+        auto locate(BookSide side, std::int64_t price) noexcept -> std::vector<PriceLevel>::iterator {
+
+            auto& levels = levelsOf( side );
+
+            if( side == BookSide::BID ){
+                return std::lower_bound( levels.begin(), levels.end(), price,
+                                         [](const PriceLevel& level, std::int64_t p){ return level.price_ < p; });
+            }
+
+            return std::lower_bound( levels.begin(), levels.end(), price,
+                                     [](const PriceLevel& level, std::int64_t p){ return level.price_ > p; });
+        }
+
+        std::vector<PriceLevel> bids_;
+        std::vector<PriceLevel> offers_;
+};
+
+// What a message did to the books: the entries applied and those skipped, of another type, with a price out of scale
+// or deleting a level which isn't in the book
+struct BookChanges{
+    std::uint32_t applied_{};
+    std::uint32_t skipped_{};
+};
+
+/**
+ * @brief Price level books, one per Symbol(55), maintained from the MarketDataSnapshotFullRefresh(W) and
+ * MarketDataIncrementalRefresh(X) messages. The entries are read from the NoMDEntries(268) group of a valid message,
+ * decoded here when the validation level of the message skipped the groups, e.g FRAMING or CHECKSUM on a trusted
+ * link. The values are converted in place without building any string.
+ * Only the bid(0) and offer(1) entries are kept, the prices are stored as ticks of 10^-priceScale
+ **/
+class BookBuilder{
+
+    public:
+
+        explicit BookBuilder(std::uint8_t priceScale = 8): priceScale_(priceScale) {}
+
+        /**
+         * @brief Apply the entries of a valid W or X message to the books, other messages are ignored.
+         * A message whose NoMDEntries(268) group cannot be decoded changes no book
+         **/
+        auto apply(const FixMessage& message) -> BookChanges {
+
+            BookChanges changes;
+
+            auto msgType = message.getValue( 35 );
+            auto isSnapshot = msgType == "W";
+
+            if( !isSnapshot && msgType != "X" ){
+                return changes;
+            }
+
+            auto entries = entriesOf( message );
+
+            if( !entries ){
+                return changes;
+            }
+
+            // The Symbol of a snapshot is at the top level, an incremental gives it in each entry
+            std::string_view symbol;
+            Book* book{};
+
+            if( isSnapshot ){
+                symbol = message.getValue( 55 );
+                book = &bookOf( symbol );
+                book->clear();
+            }
+
+            // The slots of the entries are in the message the group was decoded in
+            const auto& slots = message.groups_.empty() ? decoded_.slots_ : message.slots_;
+
+            // The members are located once for the whole group, the entries are then read by index
+            const auto& groupDef = *entries->groupDef_;
+            auto typeSlot = groupDef.slot( 269 );
+            auto priceSlot = groupDef.slot( 270 );
+            auto sizeSlot = groupDef.slot( 271 );
+            auto actionSlot = groupDef.slot( 279 );
+            auto symbolSlot = groupDef.slot( 55 );
+
+            auto fieldAt = [&](std::uint32_t entry, std::int32_t slot) -> const FieldRef* {
+
+                if( slot < 0 ){
+                    return nullptr;
+                }
+
+                auto index = slots[ entries->firstSlot_ + entry * groupDef.members_.size() + slot ];
+
+                return index == FixMessage::noField ? nullptr : &message.fields_[index];
+            };
+
+            for(std::uint32_t entry{0}; entry != entries->entryCount_; ++entry ){
+
+                auto typeField = fieldAt( entry, typeSlot );
+                auto type = typeField ? message.getValue( *typeField ) : std::string_view{};
+
+                if( type != "0" && type != "1" ){
+                    ++changes.skipped_;
+                    continue;
+                }
+
+                auto side = type == "0" ? BookSide::BID : BookSide::OFFER;
+
+                // An entry without Symbol is for the instrument of the previous one, the book is only looked up when it changes
+                if( !isSnapshot ){
+
+                    auto symbolField = fieldAt( entry, symbolSlot );
+                    auto entrySymbol = symbolField ? message.getValue( *symbolField ) : symbol;
+
+                    if( !book || entrySymbol != symbol ){
+                        symbol = entrySymbol;
+                        book = &bookOf( symbol );
+                    }
+                }
+
+                // MDEntryPx(270) and MDEntrySize(271) are PRICE and QTY fields, their type isn't looked up
+                auto priceField = fieldAt( entry, priceSlot );
+                Decimal price{};
+                std::int64_t ticks{};
+
+                if( !priceField || !parseDecimal( message.getValue( *priceField ), price ) || !toTicks( price, ticks ) ){
+                    ++changes.skipped_;
+                    continue;
+                }
+
+                auto actionField = fieldAt( entry, actionSlot );
+                auto action = actionField ? message.getValue( *actionField ) : std::string_view{"0"};
+
+                if( action == "2" ){
+                    ++( book->remove( side, ticks ) ? changes.applied_ : changes.skipped_ );
+                    continue;
+                }
+
+                auto sizeField = fieldAt( entry, sizeSlot );
+                Decimal size{};
+
+                if( !sizeField || !parseDecimal( message.getValue( *sizeField ), size ) || ( action != "0" && action != "1" ) ){
+                    ++changes.skipped_;
+                    continue;
+                }
+
+                book->set( side, ticks, size );
+                ++changes.applied_;
+            }
+
+            return changes;
+        }
+
+        /**
+         * @return the book of symbol or nullptr if no entry was received for it
+         **/
+        auto find(std::string_view symbol) const -> const Book* {
+
+            auto found = indexes_.find( symbol );
+
+            return found == indexes_.end() ? nullptr : &books_[found->second];
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return books_.size();
+        }
+
+        auto priceScale() const noexcept -> std::uint8_t {
+            return priceScale_;
+        }
+
+        /**
+         * @brief Price of a level as a Decimal
+         **/
+        auto toDecimal(const PriceLevel& level) const noexcept -> Decimal {
+            return { level.price_, priceScale_ };
+        }
+
+    private:
+
+        auto bookOf(std::string_view symbol) -> Book& {
+
+            auto found = indexes_.find( symbol );
+
+            if( found == indexes_.end() ){
+                found = indexes_.emplace( std::string(symbol), books_.size() ).first;
+                books_.emplace_back();
+            }
+
+            return books_[found->second];
+        }
+
+        // The NoMDEntries group of the message, decoded into decoded_ when the groups of the message weren't.
+        // The fields are copied into decoded_ so that the message is left as is, its buffers are reused between messages
+        auto entriesOf(const FixMessage& message) -> const GroupRef* {
+
+            if( !message.groups_.empty() || !message.dictionary_ ){
+                return message.group( 268 );
+            }
+
+            auto msgDef = message.dictionary_->message( message.getValue( 35 ) );
+
+            if( !msgDef ){
+                return nullptr;
+            }
+
+            decoded_.rawMsg_ = message.rawMsg_;
+            decoded_.dictionary_ = message.dictionary_;
+            decoded_.fields_.assign( message.fields_.begin(), message.fields_.end() );
+            decoded_.groups_.clear();
+            decoded_.slots_.clear();
+            errors_.clear();
+
+            return decodeGroups( decoded_, *msgDef, errors_ ) ? decoded_.group( 268 ) : nullptr;
+        }
+
+        // A price with more decimals than the scale is only kept if the extra ones are zeros
+        auto toTicks(Decimal price, std::int64_t& ticks) const noexcept -> bool {
+
+            auto mantissa = price.mantissa_;
+            auto scale = price.scale_;
+
+            for(; scale > priceScale_; --scale ){
+
+                if( mantissa % 10 != 0 ){
+                    return false;
+                }
+
+                mantissa /= 10;
+            }
+
+            for(; scale < priceScale_; ++scale ){
+
+                if( mantissa > INT64_MAX / 10 || mantissa < INT64_MIN / 10 ){
+                    return false;
+                }
+
+                mantissa *= 10;
+            }
+
+            ticks = mantissa;
+            return true;
+        }
+
+        std::uint8_t priceScale_;
+        std::deque<Book> books_; // A deque so that the books never move
+        std::map<std::string, std::size_t, std::less<>> indexes_; // Looked up with the symbol as is, only a new one allocates
+        FixMessage decoded_;
+        ErrorBag errors_;
+};
+
+}// namespace fixparser
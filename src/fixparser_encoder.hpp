@@ -0,0 +1,435 @@
+#pragma once
+
+#include "fixparser.hpp"
+
+namespace fixparser {
+
+/**
+ * @brief A message whose fields are mostly the same from one message to the next, e.g the orders sent on a session.
+ * The static fields are encoded once, only the slots are written for each message. The fields are kept
+ * in the order they are added, slots included. The SOH must be the one of the encoder using the template
+ **/
+class MessageTemplate{
+
+    public:
+
+        MessageTemplate(std::string_view beginString, std::string_view msgType, const char soh='|'): beginString_(beginString), soh_(soh) {
+            add( 35, msgType );
+        }
+
+        /**
+         * @brief Append a field whose value is the same in every message
+         **/
+        auto add(TagNumber tag, std::string_view value) -> MessageTemplate& {
+
+            encoded_ += std::to_string( tag );
+            encoded_ += '=';
+            encoded_ += value;
+            encoded_ += soh_;
+
+            return *this;
+        }
+
+        /**
+         * @brief Append a field whose value is given for each message
+         **/
+        auto addSlot(TagNumber tag) -> MessageTemplate& {
+
+            slots_.emplace_back( Slot{ tag, encoded_.size() } );
+            return *this;
+        }
+
+        auto slotCount() const noexcept -> std::size_t {
+            return slots_.size();
+        }
+
+    private:
+
+        friend class Encoder;
+
+        struct Slot{
+            TagNumber tag_{};
+            std::size_t offset_{}; // Position of the slot in encoded_, the static fields that follow it start there
+        };
+
+        // The static fields found between slot - 1 and slot, slotCount() being the end of the message
+        auto segment(std::size_t slot) const noexcept -> std::string_view {
+
+            auto begin = slot == 0 ? 0 : slots_[slot - 1].offset_;
+            auto end = slot == slots_.size() ? encoded_.size() : slots_[slot].offset_;
+
+            return std::string_view( encoded_ ).substr( begin, end - begin );
+        }
+
+        std::string beginString_;
+        char soh_;
+        std::string encoded_; // Every static field, MsgType included, encoded once
+        std::vector<Slot> slots_;
+};
+
+/**
+ * @brief Writes FIX messages straight into a buffer, either provided by the caller or a vector reused from one
+ * message to the next. The BodyLength(9) and CheckSum(10) fields are computed and written by finish().
+ * When the buffer of the caller is too small the message is dropped and finish() returns an empty view
+ **/
+class Encoder{
+
+    public:
+
+        Encoder(char* buffer, std::size_t capacity, const char soh='|'): data_(buffer), capacity_(capacity), soh_(soh) {}
+
+        /**
+         * @brief Encode into buffer, growing it when needed. Its memory is kept from one message to the next
+         **/
+        explicit Encoder(std::vector<char>& buffer, const char soh='|'): growable_(&buffer), soh_(soh) {
+            data_ = buffer.data();
+            capacity_ = buffer.size();
+        }
+
+        /**
+         * @brief Start a new message, the previous one is overwritten
+         **/
+        auto start(std::string_view beginString, std::string_view msgType) -> Encoder& {
+
+            template_ = nullptr;
+            startHeader( beginString );
+
+            return add( 35, msgType );
+        }
+
+        /**
+         * @brief Start a new message from a template, its static fields are copied up to the first slot.
+         * The slots are then filled in order with the add functions, the fields not in the template can
+         * be added once every slot is filled
+         **/
+        auto start(const MessageTemplate& messageTemplate) -> Encoder& {
+
+            startHeader( messageTemplate.beginString_ );
+
+            template_ = &messageTemplate;
+            nextSlot_ = 0;
+
+            append( messageTemplate.segment( 0 ) );
+
+            return *this;
+        }
+
+        auto add(TagNumber tag, std::string_view value) -> Encoder& {
+
+            if( !fieldBegin( tag, value.size() ) ){
+                return *this;
+            }
+
+            std::memcpy( data_ + size_, value.data(), value.size() );
+            size_ += value.size();
+
+            return fieldEnd();
+        }
+
+        auto addChar(TagNumber tag, char value) -> Encoder& {
+            return add( tag, std::string_view( &value, 1 ) );
+        }
+
+        auto addInt(TagNumber tag, std::int64_t value) -> Encoder& {
+
+            char digits[maxDigits];
+            auto size = formatInt( digits, value );
+
+            return add( tag, std::string_view( digits, size ) );
+        }
+
+        /**
+         * @brief Append a fixed-point value, e.g a price of { 10025, 2 } is written 100.25
+         **/
+        auto addDecimal(TagNumber tag, const Decimal& value) -> Encoder& {
+
+            char digits[maxDigits + 3];
+            std::size_t size{};
+
+            auto mantissa = value.mantissa_ < 0 ? 0 - static_cast<std::uint64_t>( value.mantissa_ ) : static_cast<std::uint64_t>( value.mantissa_ );
+            auto scale = std::min<std::size_t>( value.scale_, maxDigits - 2 );
+
+            if( value.mantissa_ < 0 ){
+                digits[size++] = '-';
+            }
+
+            char unscaled[maxDigits];
+            auto unscaledSize = formatUnsigned( unscaled, mantissa );
+
+            // The integer part is at least 0, the fraction is padded with zeros on its left, e.g { 5, 3 } is 0.005
+            if( unscaledSize <= scale ){
+                digits[size++] = '0';
+            }else{
+                std::memcpy( digits + size, unscaled, unscaledSize - scale );
+                size += unscaledSize - scale;
+            }
+
+            if( scale != 0 ){
+
+                digits[size++] = '.';
+
+                for(auto i = unscaledSize; i < scale; ++i ){
+                    digits[size++] = '0';
+                }
+
+                auto fractionSize = std::min( unscaledSize, scale );
+                std::memcpy( digits + size, unscaled + unscaledSize - fractionSize, fractionSize );
+                size += fractionSize;
+            }
+
+            return add( tag, std::string_view( digits, size ) );
+        }
+
+        /**
+         * @brief Append a UTCTIMESTAMP
+         * @param nanoseconds the number of nanoseconds since the epoch
+         * @param fractionDigits the digits of the fraction of second, 0 (none), 3 (milliseconds), 6 or 9
+         **/
+        auto addTimestamp(TagNumber tag, std::int64_t nanoseconds, unsigned fractionDigits = 3) -> Encoder& {
+
+            char text[32];
+
+            auto seconds = nanoseconds / 1000000000;
+            auto fraction = nanoseconds % 1000000000;
+
+            if( fraction < 0 ){
+                fraction += 1000000000;
+                seconds -= 1;
+            }
+
+            auto days = seconds / 86400;
+            auto secondOfDay = seconds % 86400;
+
+            if( secondOfDay < 0 ){
+                secondOfDay += 86400;
+                days -= 1;
+            }
+
+            // Civil date of the number of days since 1970-01-01, the year starting in March so that the leap day comes last
+            days += 719468;
+            auto era = ( days >= 0 ? days : days - 146096 ) / 146097;
+            auto dayOfEra = days - era * 146097;
+            auto yearOfEra = ( dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096 ) / 365;
+            auto dayOfYear = dayOfEra - ( 365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100 );
+            auto shiftedMonth = ( 5 * dayOfYear + 2 ) / 153;
+            auto day = dayOfYear - ( 153 * shiftedMonth + 2 ) / 5 + 1;
+            auto month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+            auto year = yearOfEra + era * 400 + ( month <= 2 );
+
+            formatFixed( text, year, 4 );
+            formatFixed( text + 4, month, 2 );
+            formatFixed( text + 6, day, 2 );
+            text[8] = '-';
+            formatFixed( text + 9, secondOfDay / 3600, 2 );
+            text[11] = ':';
+            formatFixed( text + 12, secondOfDay / 60 % 60, 2 );
+            text[14] = ':';
+            formatFixed( text + 15, secondOfDay % 60, 2 );
+
+            std::size_t size = 17;
+
+            if( fractionDigits != 0 ){
+
+                fractionDigits = std::min( fractionDigits, 9u );
+
+                for(auto i = fractionDigits; i != 9; ++i ){
+                    fraction /= 10;
+                }
+
+                text[size++] = '.';
+                formatFixed( text + size, fraction, fractionDigits );
+                size += fractionDigits;
+            }
+
+            return add( tag, std::string_view( text, size ) );
+        }
+
+        /**
+         * @brief Write the BodyLength and CheckSum fields
+         * @return the encoded message, or an empty view if it didn't fit in the buffer or a slot of its template wasn't filled.
+         * The view is valid until the next message is started
+         **/
+        auto finish() -> std::string_view {
+
+            if( template_ && nextSlot_ != template_->slotCount() ){
+                failed_ = true;
+            }
+
+            if( failed_ || !reserve( checkSumSize ) ){
+                return {};
+            }
+
+            // BeginString and BodyLength are written right before the body, whatever the size of the BodyLength value
+            char lengthDigits[maxDigits];
+            auto lengthSize = formatUnsigned( lengthDigits, size_ - bodyBegin_ );
+
+            if( lengthSize > maxLengthDigits ){
+                failed_ = true;
+                return {};
+            }
+
+            auto begin = bodyBegin_ - lengthSize - 4; // 4 = the size of "9=" and the SOHs ending the two fields
+            data_[bodyBegin_ - 1] = soh_;
+            std::memcpy( data_ + begin + 3, lengthDigits, lengthSize );
+            data_[begin + 1] = '9';
+            data_[begin + 2] = '=';
+            data_[begin] = soh_;
+
+            begin -= beginString_.size() + 2; // 2 = the size of "8="
+            data_[begin] = '8';
+            data_[begin + 1] = '=';
+            std::memcpy( data_ + begin + 2, beginString_.data(), beginString_.size() );
+
+            // As when checking it, the SOH counts as 1 whatever the character standing for it
+            std::uint32_t byteSum{};
+
+            for(auto i = begin; i != size_; ++i ){
+                byteSum += data_[i] == soh_ ? 1u : static_cast<unsigned char>( data_[i] );
+            }
+
+            auto checkSum = byteSum % 256;
+
+            char* out = data_ + size_;
+            out[0] = '1';
+            out[1] = '0';
+            out[2] = '=';
+            out[3] = static_cast<char>( '0' + checkSum / 100 );
+            out[4] = static_cast<char>( '0' + checkSum / 10 % 10 );
+            out[5] = static_cast<char>( '0' + checkSum % 10 );
+            out[6] = soh_;
+            size_ += checkSumSize;
+
+            return std::string_view( data_ + begin, size_ - begin );
+        }
+
+    private:
+
+        // Digits of the largest 64 bits integer and its sign
+        static constexpr std::size_t maxDigits = 21;
+        // BodyLength values written on at most 9 digits, as read back by checkBodyLength()
+        static constexpr std::size_t maxLengthDigits = 9;
+        // Size of "10=xxx" and its SOH
+        static constexpr std::size_t checkSumSize = 7;
+
+        static auto formatUnsigned(char* out, std::uint64_t value) noexcept -> std::size_t {
+
+            char reversed[maxDigits];
+            std::size_t size{};
+
+            do{
+                reversed[size++] = static_cast<char>( '0' + value % 10 );
+                value /= 10;
+            }while( value != 0 );
+
+            for(std::size_t i{0}; i != size; ++i ){
+                out[i] = reversed[size - 1 - i];
+            }
+
+            return size;
+        }
+
+        static auto formatInt(char* out, std::int64_t value) noexcept -> std::size_t {
+
+            if( value < 0 ){
+                out[0] = '-';
+                return 1 + formatUnsigned( out + 1, 0 - static_cast<std::uint64_t>( value ) );
+            }
+
+            return formatUnsigned( out, static_cast<std::uint64_t>( value ) );
+        }
+
+        // Write value on exactly width digits, padded with zeros
+        static auto formatFixed(char* out, std::int64_t value, std::size_t width) noexcept -> void {
+
+            for(auto i = width; i != 0; --i ){
+                out[i - 1] = static_cast<char>( '0' + value % 10 );
+                value /= 10;
+            }
+        }
+
+        // Leave room for the BeginString and BodyLength fields, written by finish() once the body is known
+        auto startHeader(std::string_view beginString) -> void {
+
+            beginString_ = beginString;
+            failed_ = false;
+            size_ = 0;
+
+            auto headerSize = beginString.size() + maxLengthDigits + 6; // 6 = the size of "8=", "9=" and their SOHs
+
+            if( reserve( headerSize ) ){
+                size_ = headerSize;
+            }
+
+            bodyBegin_ = size_;
+        }
+
+        auto reserve(std::size_t size) -> bool {
+
+            if( size_ + size <= capacity_ ){
+                return true;
+            }
+
+            if( !growable_ ){
+                failed_ = true;
+                return false;
+            }
+
+            growable_->resize( std::max( 2 * growable_->size(), size_ + size + 256 ) );
+            data_ = growable_->data();
+            capacity_ = growable_->size();
+
+            return true;
+        }
+
+        auto append(std::string_view bytes) -> void {
+
+            if( reserve( bytes.size() ) ){
+                std::memcpy( data_ + size_, bytes.data(), bytes.size() );
+                size_ += bytes.size();
+            }
+        }
+
+        // Write the tag and '=', with room for the value
+        auto fieldBegin(TagNumber tag, std::size_t valueSize) -> bool {
+
+            // With a template the fields must come in the order of its slots
+            if( template_ && nextSlot_ != template_->slotCount() && template_->slots_[nextSlot_].tag_ != tag ){
+                failed_ = true;
+            }
+
+            if( failed_ || !reserve( 12 + valueSize ) ){ // 12 = the size of the largest tag, '=' and the SOH
+                return false;
+            }
+
+            size_ += formatUnsigned( data_ + size_, tag );
+            data_[size_++] = '=';
+
+            return true;
+        }
+
+        // Write the SOH ending the field, and the static fields following it in the template
+        auto fieldEnd() -> Encoder& {
+
+            data_[size_++] = soh_;
+
+            if( template_ && nextSlot_ != template_->slotCount() ){
+                append( template_->segment( ++nextSlot_ ) );
+            }
+
+            return *this;
+        }
+
+        std::vector<char>* growable_{};
+        char* data_{};
+        std::size_t capacity_{};
+        std::size_t size_{};
+        std::size_t bodyBegin_{};
+        char soh_;
+        bool failed_{};
+
+        std::string beginString_;
+        const MessageTemplate* template_{};
+        std::size_t nextSlot_{};
+};
+
+}// namespace fixparser
@@ -0,0 +1,338 @@
+#pragma once
+
+#include "fixparser.hpp"
+
+#include <atomic>
+#include <exception>
+#include <map>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fixparser {
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ **/
+class MappedFile{
+
+    public:
+
+        MappedFile() = default;
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile(){
+            close();
+        }
+
+        /**
+         * @brief Map the file at path
+         * @return true if the file could be mapped, false otherwise
+         **/
+        auto open(const fs::path& path) -> bool {
+
+            close();
+
+            auto fd = ::open( path.c_str(), O_RDONLY );
+
+            if( fd < 0 ){
+                return false;
+            }
+
+            struct stat info{};
+
+            if( ::fstat( fd, &info ) != 0 ){
+                ::close( fd );
+                return false;
+            }
+
+            size_ = static_cast<std::size_t>( info.st_size );
+
+            if( size_ != 0 ){
+
+                auto mapped = ::mmap( nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+                if( mapped == MAP_FAILED ){
+                    ::close( fd );
+                    size_ = 0;
+                    return false;
+                }
+
+                // The file is read once from start to end
+                ::madvise( mapped, size_, MADV_SEQUENTIAL );
+                data_ = static_cast<const char*>( mapped );
+            }
+
+            ::close( fd );
+            return true;
+        }
+
+        auto close() noexcept -> void {
+
+            if( data_ ){
+                ::munmap( const_cast<char*>( data_ ), size_ );
+            }
+
+            data_ = nullptr;
+            size_ = 0;
+        }
+
+        auto view() const noexcept -> std::string_view {
+            return { data_, size_ };
+        }
+
+    private:
+        const char* data_{};
+        std::size_t size_{};
+};
+
+struct LogScanOptions{
+    std::size_t workers_ = std::thread::hardware_concurrency(); // 0 for the hardware concurrency
+    std::size_t chunkSize_ = 4 << 20; // Bytes of log given at once to a worker
+    bool collectOffsets_{};          // Keep the offsets of the invalid messages
+};
+
+/**
+ * @brief What was found in a log: the error counts by error and by MsgType(35)
+ **/
+struct LogScanSummary{
+    std::uint64_t messages_{};
+    std::uint64_t invalid_{};
+    std::uint64_t droppedErrors_{};                                   // Errors past the capacity of an ErrorBag, not in errors_
+    std::map<std::string, std::uint64_t> errors_;                     // Number of occurences of each error
+    std::map<std::string, std::uint64_t, std::less<>> invalidByType_; // Number of invalid messages for each MsgType
+    std::vector<std::uint64_t> badOffsets_;              // Offsets of the invalid messages in the log, sorted
+
+    auto merge(LogScanSummary&& other) -> void {
+
+        messages_ += other.messages_;
+        invalid_ += other.invalid_;
+        droppedErrors_ += other.droppedErrors_;
+
+        for(const auto& [error, count]: other.errors_ ){
+            errors_[error] += count;
+        }
+
+        for(const auto& [msgType, count]: other.invalidByType_ ){
+            invalidByType_[msgType] += count;
+        }
+
+        badOffsets_.insert( badOffsets_.end(), other.badOffsets_.begin(), other.badOffsets_.end() );
+    }
+};
+
+/**
+ * @brief Validate every message of a log holding one message per line.
+ * The log is cut in chunks at line boundaries and the chunks are validated in parallel, each worker
+ * with its own parser. The messages are validated in place, nothing is copied
+ **/
+inline auto scanLog(std::string_view log, Config& config, const LogScanOptions& options = {}) -> LogScanSummary {
+
+    // The first chunk starting at or after from, on a line boundary
+    auto chunkBegin = [&log](std::size_t from){
+
+        if( from == 0 || from >= log.size() ){
+            return std::min( from, log.size() );
+        }
+
+        auto lineEnd = log.find( '\n', from - 1 );
+        return lineEnd == std::string_view::npos ? log.size() : lineEnd + 1;
+    };
+
+    auto chunkSize = std::max<std::size_t>( options.chunkSize_, 1 );
+    auto chunks = ( log.size() + chunkSize - 1 ) / chunkSize;
+    auto workers = options.workers_ == 0 ? std::size_t{std::thread::hardware_concurrency()} : options.workers_;
+         workers = std::max<std::size_t>( 1, std::min( workers, chunks ) );
+
+    // The errors are counted by kind and tag, their text is only built the first time they're met.
+    // It's built from the kind and tag alone, the values of the message the error was first met in aren't part of it
+    struct ErrorCount{
+        std::string text_;
+        std::uint64_t count_{};
+    };
+
+    using ErrorCounts = std::map<std::pair<ErrorKind, std::uint32_t>, ErrorCount>;
+
+    std::atomic<std::size_t> nextChunk{0};
+    std::vector<LogScanSummary> summaries( workers );
+    std::vector<ErrorCounts> errorCounts( workers );
+
+    // The dictionary is resolved once before the workers start, they only read the config and share the dictionary.
+    // It's only loaded if some messages are checked up to their structure
+    auto dictionary = config.getValidation().needsDictionary() ? config.getDictionary() : config.getLoadedDictionary();
+
+    auto work = [&](std::size_t worker){
+
+        Parser parser( config, dictionary );
+        auto& summary = summaries[worker];
+        auto& counts = errorCounts[worker];
+
+        for(auto chunk = nextChunk++; chunk < chunks; chunk = nextChunk++ ){
+
+            auto pos = chunkBegin( chunk * chunkSize );
+            auto end = chunkBegin( ( chunk + 1 ) * chunkSize );
+
+            while( pos < end ){
+
+                auto lineEnd = std::min( log.find( '\n', pos ), end );
+                auto line = log.substr( pos, lineEnd - pos );
+
+                if( !line.empty() && line.back() == '\r' ){
+                    line.remove_suffix( 1 );
+                }
+
+                if( !line.empty() ){
+
+                    ++summary.messages_;
+
+                    if( !parser.checkMsgValidity( line ) ){
+
+                        ++summary.invalid_;
+
+                        const auto& errors = parser.getErrors();
+
+                        for(const auto& error: errors ){
+
+                            auto& counted = counts[ { error.kind_, error.tag_ } ];
+
+                            if( counted.count_++ == 0 ){
+
+                                // Described without the raw message so that no value of it is quoted
+                                ErrorBag labels;
+                                labels.reset( {}, errors.dictionary_, errors.soh_ );
+
+                                // Only the first line of the text, the following ones hold the values
+                                auto text = labels.describe( Error{ error.kind_, error.tag_ } );
+                                     text = text.substr( 0, text.find('\n') );
+
+                                counted.text_ = text.substr( 0, text.find_last_not_of( ": " ) + 1 );
+                            }
+                        }
+
+                        summary.droppedErrors_ += errors.dropped_;
+
+                        auto msgType = parser.getMessage().getValue( 35 );
+                             msgType = msgType.empty() ? "?" : msgType;
+
+                        auto invalid = summary.invalidByType_.find( msgType );
+
+                        if( invalid == summary.invalidByType_.end() ){
+                            invalid = summary.invalidByType_.emplace( std::string(msgType), 0 ).first;
+                        }
+
+                        ++invalid->second;
+
+                        if( options.collectOffsets_ ){
+                            summary.badOffsets_.emplace_back( pos );
+                        }
+                    }
+                }
+
+                pos = lineEnd + 1;
+            }
+        }
+    };
+
+    // A worker failing, e.g on std::bad_alloc, stops the others from taking chunks and its exception is rethrown once they're done
+    std::vector<std::exception_ptr> failures( workers );
+
+    auto guardedWork = [&](std::size_t worker){
+        try{
+            work( worker );
+        }catch(...){
+            failures[worker] = std::current_exception();
+            nextChunk = chunks;
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    auto joinAll = [&threads](){
+        for(auto& thread: threads ){
+            thread.join();
+        }
+    };
+
+    try{
+        for(std::size_t i{1}; i < workers; ++i ){
+            threads.emplace_back( guardedWork, i );
+        }
+    }catch(...){
+        nextChunk = chunks;
+        joinAll();
+        throw;
+    }
+
+    guardedWork( 0 );
+    joinAll();
+
+    for(const auto& failure: failures ){
+        if( failure ){
+            std::rethrow_exception( failure );
+        }
+    }
+
+    LogScanSummary summary;
+
+    for(auto& workerSummary: summaries ){
+        summary.merge( std::move(workerSummary) );
+    }
+
+    for(const auto& counts: errorCounts ){
+        for(const auto& [key, counted]: counts ){
+            summary.errors_[ counted.text_ ] += counted.count_;
+        }
+    }
+
+    std::sort( summary.badOffsets_.begin(), summary.badOffsets_.end() );
+
+    return summary;
+}
+
+/**
+ * @brief Map the log file at path and validate it with scanLog()
+ * @return false if the file cannot be mapped
+ **/
+inline auto scanLogFile(const fs::path& path, Config& config, LogScanSummary& summary, const LogScanOptions& options = {}) -> bool {
+
+    MappedFile file;
+
+    if( !file.open( path ) ){
+        return false;
+    }
+
+    summary = scanLog( file.view(), config, options );
+    return true;
+}
+
+inline auto operator<<(std::ostream& os, const LogScanSummary& summary) -> std::ostream& {
+
+    os << summary.messages_ << " message(s), " << summary.invalid_ << " invalid\n";
+
+    if( !summary.errors_.empty() ){
+        os << "\nErrors\n";
+        for(const auto& [error, count]: summary.errors_ ){
+            os << "  " << count << "\t" << error << "\n";
+        }
+    }
+
+    if( summary.droppedErrors_ != 0 ){
+        os << "  " << summary.droppedErrors_ << "\tErrors past the capacity of a message, not counted above\n";
+    }
+
+    if( !summary.invalidByType_.empty() ){
+        os << "\nInvalid messages by MsgType\n";
+        for(const auto& [msgType, count]: summary.invalidByType_ ){
+            os << "  " << count << "\t" << msgType << "\n";
+        }
+    }
+
+    return os;
+}
+
+}// namespace fixparser
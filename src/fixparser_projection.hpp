@@ -0,0 +1,238 @@
+#pragma once
+
+#include "fixparser.hpp"
+
+namespace fixparser {
+
+enum class ProjectionMode : char {
+    CHECKED,    // The whole message is read, its BodyLength and CheckSum are checked
+    EARLY_STOP  // The reading stops once every tag is found, the framing isn't checked
+};
+
+/**
+ * @brief Extracts the values of a few tags from raw messages, without the dictionary. The other fields are only
+ * framed and summed for the CheckSum, nothing is stored for them. Of a tag found several times, e.g in the entries
+ * of a group, the first value is kept. The values are views over the last message, which must outlive them
+ **/
+class Projection{
+
+    public:
+
+        Projection(std::initializer_list<TagNumber> tags, const char soh='|'): Projection( std::vector<TagNumber>( tags ), soh ) {}
+
+        explicit Projection(const std::vector<TagNumber>& tags, const char soh='|'): soh_(soh) {
+
+            for(auto tag: tags ){
+                if( tag != 0 && !wanted_.contains( tag ) ){
+                    wanted_.insert( tag );
+                    tags_.emplace_back( tag );
+                }
+            }
+
+            values_.resize( tags_.size() );
+        }
+
+        /**
+         * @brief Projection over a list of tags known at compile time, e.g Projection::of<35, 11, 37, 39, 14, 6>()
+         **/
+        template<TagNumber... tags>
+        static auto of(const char soh='|') -> Projection {
+            return Projection( { tags... }, soh );
+        }
+
+        /**
+         * @brief Extract the values of the tags of the projection from message, the previous values are discarded first
+         * @return false if a field has an invalid tag or, in CHECKED mode, if the framing or the CheckSum is wrong.
+         * The values found are kept either way, getErrors() tells what's wrong
+         **/
+        auto apply(std::string_view message, ProjectionMode mode = ProjectionMode::CHECKED) noexcept -> bool {
+
+            errors_.reset( message, nullptr, soh_ );
+            std::fill( values_.begin(), values_.end(), std::string_view{} );
+            found_ = 0;
+
+            std::size_t pos{};
+            std::size_t fieldCount{};
+            std::uint32_t bodyLengthOffset{};
+            std::uint32_t checkSumOffset{};
+            std::string_view bodyLength;
+            std::string_view checkSum;
+
+            while( pos < message.size() ){
+
+                auto tagBegin = pos;
+                TagNumber number{};
+
+                // The tag is converted as it's read, tags are written without leading zeros
+                while( pos < message.size() && message[pos] >= '0' && message[pos] <= '9' ){
+                    number = number * 10 + static_cast<TagNumber>( message[pos] - '0' );
+                    ++pos;
+                }
+
+                auto isTag = pos < message.size() && message[pos] == '=' && pos != tagBegin && pos - tagBegin <= 9 &&
+                             message[tagBegin] != '0';
+
+                auto valueBegin = isTag ? pos + 1 : pos;
+                auto end = std::min( message.find( soh_, valueBegin ), message.size() );
+
+                pos = end + 1;
+
+                if( !isTag ){
+                    errors_.add( ErrorKind::INVALID_TAG_NUMBER, 0, static_cast<std::uint32_t>( tagBegin ) );
+                    ++fieldCount;
+                    continue;
+                }
+
+                auto value = message.substr( valueBegin, end - valueBegin );
+
+                if( wanted_.contains( number ) ){
+
+                    auto& found = values_[ std::find( tags_.begin(), tags_.end(), number ) - tags_.begin() ];
+
+                    // A value taken from the message is never a null view, even when empty
+                    if( found.data() == nullptr ){
+
+                        found = value;
+
+                        if( ++found_ == tags_.size() && mode == ProjectionMode::EARLY_STOP ){
+                            return errors_.isEmpty();
+                        }
+                    }
+                }
+
+                if( fieldCount == 1 && number == 9 ){
+                    bodyLength = value;
+                    bodyLengthOffset = static_cast<std::uint32_t>( tagBegin );
+                }
+
+                // Only the last field can be the CheckSum
+                checkSumOffset = number == 10 ? static_cast<std::uint32_t>( tagBegin ) : 0;
+                checkSum = value;
+
+                ++fieldCount;
+            }
+
+            if( mode == ProjectionMode::EARLY_STOP ){
+                return errors_.isEmpty();
+            }
+
+            return checkFraming( message, fieldCount, bodyLengthOffset, bodyLength, checkSumOffset, checkSum ) && errors_.isEmpty();
+        }
+
+        /**
+         * @return the value of tag in the last message, empty if it wasn't found or isn't a tag of the projection
+         **/
+        auto value(TagNumber tag) const noexcept -> std::string_view {
+
+            auto found = std::find( tags_.begin(), tags_.end(), tag );
+
+            return found == tags_.end() ? std::string_view{} : values_[ found - tags_.begin() ];
+        }
+
+        auto isFound(TagNumber tag) const noexcept -> bool {
+
+            auto found = std::find( tags_.begin(), tags_.end(), tag );
+
+            return found != tags_.end() && values_[ found - tags_.begin() ].data() != nullptr;
+        }
+
+        auto allFound() const noexcept -> bool {
+            return found_ == tags_.size();
+        }
+
+        /**
+         * @brief The tags of the projection in the order they were given, duplicates removed
+         **/
+        auto tags() const noexcept -> const std::vector<TagNumber>& {
+            return tags_;
+        }
+
+        auto getErrors() const noexcept -> const ErrorBag& {
+            return errors_;
+        }
+
+    private:
+
+        // Sum of the bytes of bytes modulo 256, eight at a time: the bytes of a word are added pairwise into four
+        // 16 bits lanes, each kept modulo 256 so that it never carries into the next one
+        static auto sumBytes(std::string_view bytes) noexcept -> std::uint32_t {
+
+            constexpr std::uint64_t evenBytes = 0x00FF00FF00FF00FFull;
+
+            std::uint64_t lanes{};
+            std::size_t i{0};
+
+            for(; i + 8 <= bytes.size(); i += 8 ){
+
+                std::uint64_t word;
+                std::memcpy( &word, bytes.data() + i, sizeof(word) );
+
+                lanes = ( lanes + ( word & evenBytes ) + ( ( word >> 8 ) & evenBytes ) ) & evenBytes;
+            }
+
+            auto sum = static_cast<std::uint32_t>( ( lanes & 0xFF ) + ( ( lanes >> 16 ) & 0xFF ) + ( ( lanes >> 32 ) & 0xFF ) + ( lanes >> 48 ) );
+
+            for(; i != bytes.size(); ++i ){
+                sum += static_cast<unsigned char>( bytes[i] );
+            }
+
+            return sum;
+        }
+
+        // The checks of checkBodyLength() and checkCheckSum(), from the offsets recorded while reading the fields
+        auto checkFraming(std::string_view message, std::size_t fieldCount, std::uint32_t bodyLengthOffset, std::string_view bodyLength,
+                          std::uint32_t checkSumOffset, std::string_view checkSum) noexcept -> bool {
+
+            if( bodyLength.data() == nullptr ){
+                errors_.add( ErrorKind::TAG_OUT_OF_ORDER, 9 );
+                return false;
+            }
+
+            if( checkSumOffset == 0 ){
+                errors_.add( ErrorKind::TAG_OUT_OF_ORDER, 10 );
+                return false;
+            }
+
+            auto bodyBegin = static_cast<std::uint32_t>( bodyLength.data() - message.data() + bodyLength.size() + 1 );
+            auto computedLength = checkSumOffset - bodyBegin;
+
+            std::uint32_t declaredLength{};
+
+            if( !toUnsigned( bodyLength, declaredLength ) || declaredLength != computedLength ){
+                errors_.add( ErrorKind::BODY_LENGTH_MISMATCH, 9, bodyLengthOffset, static_cast<std::int32_t>( computedLength ),
+                             static_cast<std::int32_t>( declaredLength ) );
+                return false;
+            }
+
+            std::uint32_t expectedCheckSum{};
+
+            if( checkSum.size() != 3 || !toUnsigned( checkSum, expectedCheckSum ) ){
+                errors_.add( ErrorKind::CHECKSUM_SIZE, 10, checkSumOffset );
+                return false;
+            }
+
+            auto byteSum = sumBytes( message.substr( 0, checkSumOffset ) );
+
+            // Every field before the CheckSum ends with a SOH, which counts as 1 whatever the character standing for it
+            byteSum -= static_cast<std::uint32_t>( fieldCount - 1 ) * ( static_cast<unsigned char>( soh_ ) - 1u );
+
+            auto computedCheckSum = byteSum % 256;
+
+            if( computedCheckSum != expectedCheckSum ){
+                errors_.add( ErrorKind::CHECKSUM_MISMATCH, 10, checkSumOffset, static_cast<std::int32_t>( computedCheckSum ),
+                             static_cast<std::int32_t>( expectedCheckSum ) );
+                return false;
+            }
+
+            return true;
+        }
+
+        char soh_;
+        std::vector<TagNumber> tags_;
+        TagSet wanted_;
+        std::vector<std::string_view> values_; // Null views for the tags not found
+        std::size_t found_{};
+        ErrorBag errors_;
+};
+
+}// namespace fixparser
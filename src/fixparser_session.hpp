@@ -0,0 +1,435 @@
+#pragma once
+
+#include "fixparser.hpp"
+
+namespace fixparser {
+
+// Range of sequence numbers [begin_, end_] as in a ResendRequest(2), empty when begin_ is 0.
+// An end_ of 0 stands for every message up to the last one, as EndSeqNo(16) does
+struct SeqRange{
+    std::uint64_t begin_{};
+    std::uint64_t end_{};
+
+    auto isEmpty() const noexcept -> bool {
+        return begin_ == 0;
+    }
+
+    auto contains(std::uint64_t seqNum) const noexcept -> bool {
+        return !isEmpty() && seqNum >= begin_ && ( end_ == 0 || seqNum <= end_ );
+    }
+};
+
+enum class SequenceStatus : char {
+    IN_SEQUENCE,      // The MsgSeqNum expected
+    GAP,              // Above the one expected, the messages in between are missing
+    RESENT,           // A PossDup message filling a gap
+    DUPLICATE,        // A PossDup message already received, to be ignored
+    TOO_LOW,          // Below the one expected without PossDupFlag(43), the session is to be ended
+    RESET,            // Logon with ResetSeqNumFlag(141) or SequenceReset(4) in reset mode, the numbers start over
+    INVALID_RESET,    // SequenceReset(4) lowering the number expected, to be rejected
+    INCOMPLETE_HEADER // No valid MsgSeqNum(34), SenderCompID(49) or TargetCompID(56)
+};
+
+/**
+ * @brief What a message means for the sequence of its session, and what's to be done about it
+ **/
+struct SequenceEvent{
+    SequenceStatus status_{SequenceStatus::INCOMPLETE_HEADER};
+    std::uint64_t seqNum_{};   // MsgSeqNum(34) of the message
+    std::uint64_t expected_{}; // MsgSeqNum expected before the message
+    SeqRange missing_;         // GAP: the messages to ask for with a ResendRequest(2)
+    SeqRange toResend_;        // ResendRequest(2) received: the messages to send again, or to skip with a SequenceReset-GapFill(4)
+
+    auto needsResendRequest() const noexcept -> bool {
+        return !missing_.isEmpty();
+    }
+
+    auto needsResend() const noexcept -> bool {
+        return !toResend_.isEmpty();
+    }
+
+    auto needsLogout() const noexcept -> bool {
+        return status_ == SequenceStatus::TOO_LOW;
+    }
+};
+
+/**
+ * @brief Sequence state of the messages received on a session.
+ * The missing messages are kept as a few ranges, a gap found when they're all taken is merged with the last one
+ **/
+struct SessionState{
+    static constexpr std::size_t maxGaps = 4;
+
+    std::uint64_t nextSeqNum_{1}; // MsgSeqNum expected for the next message
+    std::uint64_t messages_{};
+    std::uint64_t gaps_{};
+    std::uint64_t resent_{};
+    std::uint64_t duplicates_{};
+    std::array<SeqRange, maxGaps> missing_{};
+    std::uint32_t missingCount_{};
+
+    auto isMissing(std::uint64_t seqNum) const noexcept -> bool {
+
+        for(std::uint32_t i{0}; i != missingCount_; ++i ){
+            if( missing_[i].contains( seqNum ) ){
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Gaps are always found above the previous ones, the ranges stay sorted
+    auto addMissing(SeqRange range) noexcept -> void {
+
+        if( missingCount_ == maxGaps ){
+            missing_[maxGaps - 1].end_ = range.end_;
+            return;
+        }
+
+        missing_[missingCount_++] = range;
+    }
+
+    /**
+     * @brief Remove [begin, end] from the missing ranges, a range is only split while there's room for both parts
+     **/
+    auto fill(std::uint64_t begin, std::uint64_t end) noexcept -> void {
+
+        for(std::uint32_t i{0}; i != missingCount_; ){
+
+            auto& range = missing_[i];
+
+            if( end < range.begin_ || begin > range.end_ ){
+                ++i;
+                continue;
+            }
+
+            if( begin <= range.begin_ && end >= range.end_ ){
+                std::copy( missing_.begin() + i + 1, missing_.begin() + missingCount_, missing_.begin() + i );
+                missing_[--missingCount_] = {};
+                continue;
+            }
+
+            if( begin <= range.begin_ ){
+                range.begin_ = end + 1;
+            }else if( end >= range.end_ ){
+                range.end_ = begin - 1;
+            }else if( missingCount_ != maxGaps ){
+                std::copy_backward( missing_.begin() + i + 1, missing_.begin() + missingCount_, missing_.begin() + missingCount_ + 1 );
+                missing_[i + 1] = { end + 1, range.end_ };
+                range.end_ = begin - 1;
+                ++missingCount_;
+            }
+
+            ++i;
+        }
+    }
+
+    auto clearMissing() noexcept -> void {
+        missing_ = {};
+        missingCount_ = 0;
+    }
+};
+
+/**
+ * @brief Sequence tracking of many sessions, keyed by the SenderCompID(49) and TargetCompID(56) of the messages received.
+ * The sessions are kept in an open addressing table, looking one up hashes the CompIDs and probes from there.
+ * Meant to be run on every valid message right after the parser, by a single thread
+ **/
+class SessionTable{
+
+    public:
+
+        explicit SessionTable(std::size_t sessions = 64){
+            entries_.resize( capacityFor( sessions ) );
+        }
+
+        /**
+         * @brief Update the session of a valid message and tell where the message stands in its sequence
+         **/
+        auto onMessage(const FixMessage& message) -> SequenceEvent {
+
+            HeaderValues values;
+
+            if( !read( message, values ) ){
+                return {};
+            }
+
+            auto& state = session( values.sender_, values.target_ );
+
+            SequenceEvent event;
+            event.seqNum_ = values.seqNum_;
+            event.expected_ = state.nextSeqNum_;
+
+            ++state.messages_;
+
+            if( values.msgType_ == "A" && values.resetSeqNum_ ){
+                state.clearMissing();
+                state.nextSeqNum_ = values.seqNum_ + 1;
+                event.status_ = SequenceStatus::RESET;
+                return event;
+            }
+
+            // In reset mode the MsgSeqNum of a SequenceReset is ignored
+            if( values.msgType_ == "4" && !values.gapFill_ ){
+
+                if( values.newSeqNo_ < state.nextSeqNum_ ){
+                    event.status_ = SequenceStatus::INVALID_RESET;
+                    return event;
+                }
+
+                state.fill( 1, values.newSeqNo_ - 1 );
+                state.nextSeqNum_ = values.newSeqNo_;
+                event.status_ = SequenceStatus::RESET;
+                return event;
+            }
+
+            if( values.seqNum_ == state.nextSeqNum_ ){
+
+                event.status_ = SequenceStatus::IN_SEQUENCE;
+                ++state.nextSeqNum_;
+
+            }else if( values.seqNum_ > state.nextSeqNum_ ){
+
+                event.status_ = SequenceStatus::GAP;
+                event.missing_ = { state.nextSeqNum_, values.seqNum_ - 1 };
+
+                state.addMissing( event.missing_ );
+                state.nextSeqNum_ = values.seqNum_ + 1;
+                ++state.gaps_;
+
+            }else if( !values.possDup_ ){
+
+                // Nothing else is done with a message the session is to be ended for
+                event.status_ = SequenceStatus::TOO_LOW;
+                return event;
+
+            }else if( state.isMissing( values.seqNum_ ) ){
+
+                event.status_ = SequenceStatus::RESENT;
+                state.fill( values.seqNum_, values.seqNum_ );
+                ++state.resent_;
+
+            }else{
+
+                event.status_ = SequenceStatus::DUPLICATE;
+                ++state.duplicates_;
+                return event;
+            }
+
+            // A GapFill stands for every message up to NewSeqNo(36)
+            if( values.msgType_ == "4" && values.newSeqNo_ > values.seqNum_ ){
+
+                state.fill( values.seqNum_, values.newSeqNo_ - 1 );
+                state.nextSeqNum_ = std::max( state.nextSeqNum_, values.newSeqNo_ );
+            }
+
+            if( values.msgType_ == "2" ){
+                event.toResend_ = { values.beginSeqNo_, values.endSeqNo_ };
+            }
+
+            return event;
+        }
+
+        /**
+         * @brief The state of a session, created if it's not known yet, e.g to restore its numbers at startup
+         **/
+        auto session(std::string_view sender, std::string_view target) -> SessionState& {
+
+            auto hash = hashOf( sender, target );
+            auto slot = probe( hash, sender, target );
+
+            if( entries_[slot].isUsed_ ){
+                return entries_[slot].state_;
+            }
+
+            // Kept at most half full so that probes stay short
+            if( 2 * ( size_ + 1 ) > entries_.size() ){
+                rehash( 2 * entries_.size() );
+                slot = probe( hash, sender, target );
+            }
+
+            auto& entry = entries_[slot];
+            entry.hash_ = hash;
+            entry.sender_ = sender;
+            entry.target_ = target;
+            entry.isUsed_ = true;
+
+            ++size_;
+
+            return entry.state_;
+        }
+
+        /**
+         * @return the state of the session or nullptr if no message of it was seen
+         **/
+        auto find(std::string_view sender, std::string_view target) const noexcept -> const SessionState* {
+
+            const auto& entry = entries_[ probe( hashOf( sender, target ), sender, target ) ];
+
+            return entry.isUsed_ ? &entry.state_ : nullptr;
+        }
+
+        /**
+         * @brief Call f( sender, target, state ) for every session
+         **/
+        template <typename F>
+        auto forEach(F&& f) const -> void {
+            for(const auto& entry: entries_ ){
+                if( entry.isUsed_ ){
+                    f( std::string_view( entry.sender_ ), std::string_view( entry.target_ ), entry.state_ );
+                }
+            }
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return size_;
+        }
+
+    private:
+
+        struct Entry{
+            std::uint64_t hash_{};
+            std::string sender_;
+            std::string target_;
+            SessionState state_;
+            bool isUsed_{};
+        };
+
+        // The fields of a message that matter to its session
+        struct HeaderValues{
+            std::string_view sender_;
+            std::string_view target_;
+            std::string_view msgType_;
+            std::uint64_t seqNum_{};
+            bool possDup_{};
+            bool resetSeqNum_{};
+            bool gapFill_{};
+            std::uint64_t newSeqNo_{};
+            std::uint64_t beginSeqNo_{};
+            std::uint64_t endSeqNo_{};
+        };
+
+        static auto capacityFor(std::size_t sessions) noexcept -> std::size_t {
+
+            std::size_t capacity{16};
+
+            while( capacity < 2 * sessions ){
+                capacity *= 2;
+            }
+
+            return capacity;
+        }
+
+        // FNV-1a of both CompIDs, with a separator so that "AB","C" and "A","BC" differ
+        static auto hashOf(std::string_view sender, std::string_view target) noexcept -> std::uint64_t {
+
+            std::uint64_t hash = 14695981039346656037ull;
+
+            auto add = [&hash](unsigned char c){
+                hash ^= c;
+                hash *= 1099511628211ull;
+            };
+
+            for(auto c: sender ){
+                add( static_cast<unsigned char>( c ) );
+            }
+
+            add( 0x01 );
+
+            for(auto c: target ){
+                add( static_cast<unsigned char>( c ) );
+            }
+
+            return hash;
+        }
+
+        // The slot holding the session, or the free slot where it would go
+        auto probe(std::uint64_t hash, std::string_view sender, std::string_view target) const noexcept -> std::size_t {
+
+            auto mask = entries_.size() - 1;
+
+            for(auto slot = static_cast<std::size_t>( hash ) & mask; ; slot = ( slot + 1 ) & mask ){
+
+                const auto& entry = entries_[slot];
+
+                if( !entry.isUsed_ || ( entry.hash_ == hash && entry.sender_ == sender && entry.target_ == target ) ){
+                    return slot;
+                }
+            }
+        }
+
+        auto rehash(std::size_t capacity) -> void {
+
+            std::vector<Entry> entries( capacity );
+            std::swap( entries, entries_ );
+
+            auto mask = capacity - 1;
+
+            for(auto& entry: entries ){
+
+                if( !entry.isUsed_ ){
+                    continue;
+                }
+
+                auto slot = static_cast<std::size_t>( entry.hash_ ) & mask;
+
+                while( entries_[slot].isUsed_ ){
+                    slot = ( slot + 1 ) & mask;
+                }
+
+                entries_[slot] = std::move(entry);
+            }
+        }
+
+        // The header comes first, the body is only read for the session messages carrying sequence fields
+        static auto read(const FixMessage& message, HeaderValues& values) noexcept -> bool {
+
+            std::string_view seqNum;
+            bool readsBody{true};
+
+            for(const auto& field: message.fields_ ){
+
+                auto value = message.getValue( field );
+
+                switch( field.number_ ){
+                    case 49:  values.sender_ = value; break;
+                    case 56:  values.target_ = value; break;
+                    case 35:
+                        values.msgType_ = value;
+                        readsBody = value == "A" || value == "4" || value == "2";
+                        break;
+                    case 34:  seqNum = value; break;
+                    case 43:  values.possDup_ = value == "Y"; break;
+                    case 141: values.resetSeqNum_ = value == "Y"; break;
+                    case 123: values.gapFill_ = value == "Y"; break;
+                    case 36:  values.newSeqNo_ = toSeqNum( value ); break;
+                    case 7:   values.beginSeqNo_ = toSeqNum( value ); break;
+                    case 16:  values.endSeqNo_ = toSeqNum( value ); break;
+                    default:
+                        break;
+                }
+
+                if( !readsBody && message.getPlacement( field ) == Placement::BODY ){
+                    break;
+                }
+            }
+
+            values.seqNum_ = toSeqNum( seqNum );
+
+            return values.seqNum_ != 0 && !values.sender_.empty() && !values.target_.empty();
+        }
+
+        // 0 when value isn't a sequence number
+        static auto toSeqNum(std::string_view value) noexcept -> std::uint64_t {
+
+            std::int64_t number{};
+
+            return parseInt( value, number ) && number > 0 ? static_cast<std::uint64_t>( number ) : 0;
+        }
+
+        std::vector<Entry> entries_;
+        std::size_t size_{};
+};
+
+}// namespace fixparser
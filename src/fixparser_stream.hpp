@@ -0,0 +1,247 @@
+#pragma once
+
+#include "fixparser.hpp"
+
+namespace fixparser {
+
+enum class FrameStatus : char {
+    COMPLETE,
+    INCOMPLETE,
+    INVALID
+};
+
+struct Frame{
+    FrameStatus status_{FrameStatus::INCOMPLETE};
+    std::size_t length_{}; // COMPLETE: size of the message, INCOMPLETE: size needed if already known, INVALID: bytes to skip
+};
+
+/**
+ * @brief Find the boundaries of the message starting at the beginning of data.
+ * Only the framing is checked: the BeginString prefix, the BodyLength value and the CheckSum field found right after the body
+ * @return the frame status with its length
+ **/
+inline auto findFrame(std::string_view data, const char soh, std::size_t maxMessageSize) noexcept -> Frame {
+
+    // Every BeginString starts with FIX, e.g 8=FIX.4.4 or 8=FIXT.1.1
+    constexpr std::string_view beginString = "8=FIX";
+    // BeginString and BodyLength values are never this long, past it the data is garbage
+    constexpr std::size_t maxFieldSize = 32;
+
+    auto prefixSize = std::min( data.size(), beginString.size() );
+
+    if( data.substr( 0, prefixSize ) != beginString.substr( 0, prefixSize ) ){
+        return { FrameStatus::INVALID, 1 };
+    }
+
+    auto versionEnd = data.find( soh );
+
+    if( versionEnd == std::string_view::npos ){
+        return data.size() > maxFieldSize ? Frame{ FrameStatus::INVALID, 1 } : Frame{ FrameStatus::INCOMPLETE, 0 };
+    }
+
+    auto lengthBegin = versionEnd + 1;
+
+    if( data.size() < lengthBegin + 2 ){
+        return { FrameStatus::INCOMPLETE, 0 };
+    }
+
+    if( data[lengthBegin] != '9' || data[lengthBegin + 1] != '=' ){
+        return { FrameStatus::INVALID, 1 };
+    }
+
+    auto lengthEnd = data.find( soh, lengthBegin + 2 );
+
+    if( lengthEnd == std::string_view::npos ){
+        return data.size() - lengthBegin > maxFieldSize ? Frame{ FrameStatus::INVALID, 1 } : Frame{ FrameStatus::INCOMPLETE, 0 };
+    }
+
+    std::uint32_t bodyLength{};
+
+    if( !toUnsigned( data.substr( lengthBegin + 2, lengthEnd - lengthBegin - 2 ), bodyLength ) ){
+        return { FrameStatus::INVALID, 1 };
+    }
+
+    auto bodyEnd = lengthEnd + 1 + bodyLength;
+    auto messageSize = bodyEnd + 7; // 7 = the size of the CheckSum field "10=xxx" and its SOH
+
+    if( messageSize > maxMessageSize ){
+        return { FrameStatus::INVALID, 1 };
+    }
+
+    if( data.size() < messageSize ){
+        return { FrameStatus::INCOMPLETE, messageSize };
+    }
+
+    std::uint32_t checkSum{};
+
+    if( data.substr( bodyEnd, 3 ) != "10=" || !toUnsigned( data.substr( bodyEnd + 3, 3 ), checkSum ) || data[bodyEnd + 6] != soh ){
+        return { FrameStatus::INVALID, 1 };
+    }
+
+    return { FrameStatus::COMPLETE, messageSize };
+}
+
+/**
+ * @brief Incremental framer cutting FIX messages out of a byte stream, e.g the chunks read from a socket.
+ * The messages found entirely inside a chunk are handed out as views over that chunk without any copy.
+ * Only a message spanning several chunks is copied into an internal buffer until it's complete.
+ * Bytes that can't be the start of a message are skipped until the next BeginString
+ **/
+class StreamDecoder{
+
+    public:
+
+        explicit StreamDecoder(const char soh='|', std::size_t maxMessageSize = 1 << 20): soh_(soh), maxMessageSize_(maxMessageSize) {}
+
+        explicit StreamDecoder(const Config& config, std::size_t maxMessageSize = 1 << 20): StreamDecoder(config.getSOH(), maxMessageSize) {}
+
+        /**
+         * @brief Feed the next chunk of the stream.
+         * onMessage is called with a std::string_view of every complete message, in order. The view is only valid
+         * during the call since it may refer to chunk or to the internal buffer
+         * @return the number of messages found in this chunk
+         **/
+        template<typename F>
+        auto feed(std::string_view chunk, F&& onMessage) -> std::size_t {
+
+            std::size_t found{};
+            std::size_t pos{};
+            std::size_t appended{}; // Bytes of this chunk sitting at the end of partial_
+
+            // First complete the message left over by the previous chunks
+            while( !partial_.empty() ){
+
+                auto frame = findFrame( partial_, soh_, maxMessageSize_ );
+
+                if( frame.status_ == FrameStatus::INCOMPLETE ){
+
+                    if( pos == chunk.size() ){
+                        break;
+                    }
+
+                    // Until the BodyLength is known the header is completed a few bytes at a time
+                    auto needed = frame.length_ > partial_.size() ? frame.length_ - partial_.size() : headerChunk;
+                    auto taken = std::min( needed, chunk.size() - pos );
+
+                    partial_.append( chunk.data() + pos, taken );
+                    pos += taken;
+                    appended += taken;
+
+                }else if( frame.status_ == FrameStatus::COMPLETE ){
+
+                    // Whatever was taken from the chunk past the end of the message is given back to it
+                    auto givenBack = std::min( partial_.size() - frame.length_, appended );
+                    pos -= givenBack;
+
+                    onMessage( std::string_view( partial_.data(), frame.length_ ) );
+                    ++found;
+
+                    partial_.erase( 0, frame.length_ );
+                    partial_.resize( partial_.size() - givenBack );
+                    appended = 0;
+
+                }else{
+                    partial_.erase( 0, frame.length_ );
+                    discarded_ += frame.length_;
+                    discarded_ += resync( partial_ );
+                    appended = std::min( appended, partial_.size() );
+                }
+            }
+
+            // Then every message found in the chunk itself is handed out without copy
+            while( pos < chunk.size() ){
+
+                auto rest = chunk.substr( pos );
+                auto skipped = resync( rest );
+
+                discarded_ += skipped;
+                pos += skipped;
+                rest.remove_prefix( skipped );
+
+                if( rest.empty() ){
+                    break;
+                }
+
+                auto frame = findFrame( rest, soh_, maxMessageSize_ );
+
+                if( frame.status_ == FrameStatus::COMPLETE ){
+                    onMessage( rest.substr( 0, frame.length_ ) );
+                    ++found;
+                    pos += frame.length_;
+                }else if( frame.status_ == FrameStatus::INVALID ){
+                    discarded_ += frame.length_;
+                    pos += frame.length_;
+                }else{
+                    partial_.assign( rest.data(), rest.size() );
+                    pos = chunk.size();
+                }
+            }
+
+            return found;
+        }
+
+        /**
+         * @brief Number of bytes of an incomplete message waiting for the next chunks
+         **/
+        auto pending() const noexcept -> std::size_t {
+            return partial_.size();
+        }
+
+        /**
+         * @brief Number of bytes skipped since they weren't part of any valid frame
+         **/
+        auto discarded() const noexcept -> std::uint64_t {
+            return discarded_;
+        }
+
+        /**
+         * @brief Forget the incomplete message and clear the discarded() count, e.g when the connection is reset
+         **/
+        auto reset() noexcept -> void {
+            partial_.clear();
+            discarded_ = 0;
+        }
+
+    private:
+
+        // Bytes appended at once to an incomplete header whose BodyLength isn't known yet
+        static constexpr std::size_t headerChunk = 32;
+
+        /**
+         * @brief Skip the bytes before the next possible BeginString.
+         * A few trailing bytes are kept if they may be the beginning of one, the next chunk will tell
+         * @return the number of bytes skipped
+         **/
+        template<typename S>
+        auto resync(S& data) const -> std::size_t {
+
+            constexpr std::string_view beginString = "8=FIX";
+
+            std::string_view view( data );
+            auto begin = view.find( beginString );
+
+            if( begin == std::string_view::npos ){
+
+                begin = view.size();
+
+                for(std::size_t kept{1}; kept < beginString.size() && kept <= view.size(); ++kept ){
+                    if( view.substr( view.size() - kept ) == beginString.substr( 0, kept ) ){
+                        begin = view.size() - kept;
+                    }
+                }
+            }
+
+            if constexpr( std::is_same_v<S, std::string> ){
+                data.erase( 0, begin );
+            }
+
+            return begin;
+        }
+
+        char soh_;
+        std::size_t maxMessageSize_;
+        std::string partial_;
+        std::uint64_t discarded_{};
+};
+
+}// namespace fixparser
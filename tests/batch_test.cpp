@@ -0,0 +1,131 @@
+#include "fixparser_batch.hpp"
+#include "fixparser_encoder.hpp"
+#include <iostream>
+
+// The results of BatchValidator must be those of a single Parser validating the messages one after the other,
+// whatever the size of the batch and the number of workers
+
+namespace {
+
+using namespace fixparser;
+
+// A small specification with the fields of a header, a trailer and one MsgType, no file is read
+auto testDictionary() -> std::shared_ptr<const Dictionary> {
+
+    static SpecField fields[60]{};
+    static constexpr SpecValue values[] = { {"1", "BUY"}, {"2", "SELL"} };
+    static constexpr TagNumber required[] = { 8, 9, 35, 10, 55, 54 };
+    static constexpr SpecMessage messages[] = { {"NewOrderSingle", "D", "app", {4, 2}, {0, 0}} };
+
+    fields[8] = { "BeginString", "STRING", Placement::HEADER, {} };
+    fields[9] = { "BodyLength", "LENGTH", Placement::HEADER, {} };
+    fields[35] = { "MsgType", "STRING", Placement::HEADER, {} };
+    fields[34] = { "MsgSeqNum", "SEQNUM", Placement::HEADER, {} };
+    fields[10] = { "CheckSum", "STRING", Placement::TRAILER, {} };
+    fields[55] = { "Symbol", "STRING", Placement::BODY, {} };
+    fields[54] = { "Side", "CHAR", Placement::BODY, {0, 2} };
+    fields[38] = { "OrderQty", "QTY", Placement::BODY, {} };
+
+    SpecTables tables{ fields, 59, values, required, messages, 1, {0, 3}, {3, 1}, nullptr, nullptr };
+
+    return Dictionary::fromTables( tables );
+}
+
+// Valid and invalid messages in turn: bad value, missing field, unknown tag, bad checksum
+auto corpus(std::size_t count) -> std::vector<std::string> {
+
+    std::vector<char> buffer;
+    Encoder encoder( buffer );
+    std::vector<std::string> messages;
+
+    for(std::size_t i{0}; i != count; ++i ){
+
+        encoder.start( "FIX.4.4", "D" ).addInt( 34, static_cast<std::int64_t>( i + 1 ) ).add( 55, "BTCUSD" );
+
+        switch( i % 5 ){
+            case 1:  encoder.addChar( 54, '7' ); break;
+            case 2:  break;
+            case 3:  encoder.addChar( 54, '1' ).add( 9999, "x" ); break;
+            default: encoder.addChar( 54, '2' ).addDecimal( 38, { 150, 0 } ); break;
+        }
+
+        messages.emplace_back( encoder.finish() );
+
+        if( i % 5 == 4 ){
+            messages.back()[ messages.back().size() - 2 ] ^= 1;
+        }
+    }
+
+    return messages;
+}
+
+auto sameErrors(const ErrorBag& lhs, const ErrorBag& rhs) -> bool {
+
+    if( lhs.size() != rhs.size() || lhs.dropped_ != rhs.dropped_ ){
+        return false;
+    }
+
+    for(std::size_t i{0}; i != lhs.size(); ++i ){
+        if( lhs[i].kind_ != rhs[i].kind_ || lhs[i].tag_ != rhs[i].tag_ || lhs[i].offset_ != rhs[i].offset_ ){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto check(BatchValidator& validator, Config& config, std::size_t count) -> bool {
+
+    auto messages = corpus( count );
+    std::vector<std::string_view> views( messages.begin(), messages.end() );
+
+    BatchResult result;
+    validator.validate( views, result );
+
+    if( result.valid_.size() != count || result.errors_.size() != count ){
+        std::cerr << count << " messages on " << validator.workers() << " worker(s): result not sized to the batch\n";
+        return false;
+    }
+
+    Parser parser( config );
+
+    for(std::size_t i{0}; i != count; ++i ){
+
+        auto isValid = parser.checkMsgValidity( views[i] );
+
+        if( static_cast<bool>( result.valid_[i] ) != isValid || ( !isValid && !sameErrors( result.errors_[i], parser.getErrors() ) ) ){
+            std::cerr << count << " messages on " << validator.workers() << " worker(s): message " << i << " differs\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}// namespace
+
+auto main() -> int {
+
+    Config config( testDictionary() );
+    config.setValidation( ValidationLevel::FULL );
+    bool isValid{true};
+
+    for(std::size_t workers: { 1, 2, 4, 16 } ){
+
+        // The same validator is reused for every batch, smaller than a grain, with fewer messages than workers or larger
+        BatchValidator validator( config, workers );
+
+        for(std::size_t count: { 0, 1, 3, 10, 63, 64, 65, 1000, 10007 } ){
+            isValid &= check( validator, config, count );
+        }
+    }
+
+    std::vector<std::string_view> none;
+    BatchResult result;
+    validateBatch( none, config, result, 4 );
+
+    isValid &= result.valid_.empty();
+
+    std::cout << ( isValid ? "batch_test passed\n" : "batch_test failed\n" );
+    return isValid ? 0 : 1;
+}